@@ -25,12 +25,14 @@ constexpr const wchar_t* ENCODER_ID_Maya = L"MayaEncoder";
 constexpr const wchar_t* EO_EMIT_ATTRIBUTES = L"emitAttributes";
 constexpr const wchar_t* EO_EMIT_MATERIALS = L"emitMaterials";
 constexpr const wchar_t* EO_EMIT_REPORTS = L"emitReports";
+constexpr const wchar_t* EO_BOUNDING_BOXES_ONLY = L"boundingBoxesOnly";
 
 class IMayaCallbacks : public prt::Callbacks {
 public:
 	~IMayaCallbacks() override = default;
 
 	/**
+	 * @param initialShapeIndex index of the initial shape in the generate call which produced this mesh
 	 * @param name initial shape (primitive group) name, optionally used to create primitive groups on output
 	 * @param vtx vertex coordinate array
 	 * @param length of vertex coordinate array
@@ -42,7 +44,7 @@ public:
 	 * @param indicesSize vertex attribute index array
 	 * @param uvs array of texture coordinate arrays (same indexing as vertices per uv set)
 	 * @param uvsSizes lengths of uv arrays per uv set
-	 * @param uvSetsCount number of uv sets
+	 * @param uvSetsCount number of uv sets, sets with identical data share the same arrays (identical pointers)
 	 * @param faceRanges ranges for materials and reports
 	 * @param materials contains faceRangesSize-1 attribute maps (all materials must have an identical set of keys and
 	 * types)
@@ -50,7 +52,8 @@ public:
 	 * @param shapeIDs shape ids per face, contains faceRangesSize-1 values
 	 */
 	// clang-format off
-	virtual void addMesh(const wchar_t* name,
+	virtual void addMesh(size_t initialShapeIndex,
+	                     const wchar_t* name,
 	                     const double* vtx, size_t vtxSize,
 	                     const double* nrm, size_t nrmSize,
 	                     const uint32_t* faceCounts, size_t faceCountsSize,
@@ -80,4 +83,19 @@ public:
 	 */
 	virtual void addAsset(const wchar_t* uri, const wchar_t* fileName, const uint8_t* buffer, size_t size,
 	                      wchar_t* result, size_t& resultSize) = 0;
+
+	/**
+	 * Passes the final values of the generic attributes of an initial shape at once (see EO_EMIT_ATTRIBUTES).
+	 *
+	 * @param initialShapeIndex index of the initial shape in the generate call
+	 * @param shapeID id of the leaf shape the values were taken from
+	 * @param attributes final attribute values, only valid during the call
+	 */
+	virtual void addAttributes(size_t initialShapeIndex, int32_t shapeID, const prt::AttributeMap* attributes) = 0;
+
+	/**
+	 * @param initialShapeIndex index of the initial shape in the generate call
+	 * @return true if the result of the initial shape is no longer needed, the encoder then stops encoding it
+	 */
+	virtual bool isCanceled(size_t initialShapeIndex) const = 0;
 };
@@ -0,0 +1,132 @@
+/**
+ * Serlio - Esri CityEngine Plugin for Autodesk Maya
+ *
+ * See https://github.com/esri/serlio for build and usage instructions.
+ *
+ * Copyright (c) 2012-2022 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+
+// we blacklist all CGA-style material attribute keys, see prtx/Material.h
+// sorted for binary search, the keys are checked for every material of every mesh
+constexpr std::array<std::wstring_view, 48> MATERIAL_ATTRIBUTE_BLACKLIST = {
+        L"ambient.b",
+        L"ambient.g",
+        L"ambient.r",
+        L"bumpmap",
+        L"bumpmap.rw",
+        L"bumpmap.su",
+        L"bumpmap.sv",
+        L"bumpmap.tu",
+        L"bumpmap.tv",
+        L"color.a",
+        L"color.b",
+        L"color.g",
+        L"color.r",
+        L"color.rgb",
+        L"colormap",
+        L"colormap.rw",
+        L"colormap.su",
+        L"colormap.sv",
+        L"colormap.tu",
+        L"colormap.tv",
+        L"dirtmap",
+        L"dirtmap.rw",
+        L"dirtmap.su",
+        L"dirtmap.sv",
+        L"dirtmap.tu",
+        L"dirtmap.tv",
+        L"normalmap",
+        L"normalmap.rw",
+        L"normalmap.su",
+        L"normalmap.sv",
+        L"normalmap.tu",
+        L"normalmap.tv",
+        L"opacitymap",
+        L"opacitymap.mode",
+        L"opacitymap.rw",
+        L"opacitymap.su",
+        L"opacitymap.sv",
+        L"opacitymap.tu",
+        L"opacitymap.tv",
+        L"specular.b",
+        L"specular.g",
+        L"specular.r",
+        L"specularmap",
+        L"specularmap.rw",
+        L"specularmap.su",
+        L"specularmap.sv",
+        L"specularmap.tu",
+        L"specularmap.tv"};
+
+#if PRT_VERSION_MAJOR > 1
+// also blacklist CGA-style PBR attrs from CE 2019.0, PRT 2.x
+constexpr std::array<std::wstring_view, 27> MATERIAL_ATTRIBUTE_BLACKLIST_PBR = {
+        L"emissive.b",
+        L"emissive.g",
+        L"emissive.r",
+        L"emissivemap",
+        L"emissivemap.rw",
+        L"emissivemap.su",
+        L"emissivemap.sv",
+        L"emissivemap.tu",
+        L"emissivemap.tv",
+        L"metallicmap",
+        L"metallicmap.rw",
+        L"metallicmap.su",
+        L"metallicmap.sv",
+        L"metallicmap.tu",
+        L"metallicmap.tv",
+        L"occlusionmap",
+        L"occlusionmap.rw",
+        L"occlusionmap.su",
+        L"occlusionmap.sv",
+        L"occlusionmap.tu",
+        L"occlusionmap.tv",
+        L"roughnessmap",
+        L"roughnessmap.rw",
+        L"roughnessmap.su",
+        L"roughnessmap.sv",
+        L"roughnessmap.tu",
+        L"roughnessmap.tv"};
+#endif
+
+template <size_t N>
+constexpr bool isStrictlySorted(const std::array<std::wstring_view, N>& keys) {
+	for (size_t i = 1; i < N; i++) {
+		if (!(keys[i - 1] < keys[i]))
+			return false;
+	}
+	return true;
+}
+
+static_assert(isStrictlySorted(MATERIAL_ATTRIBUTE_BLACKLIST), "blacklist must be sorted");
+#if PRT_VERSION_MAJOR > 1
+static_assert(isStrictlySorted(MATERIAL_ATTRIBUTE_BLACKLIST_PBR), "blacklist must be sorted");
+#endif
+
+inline bool isBlacklisted(std::wstring_view key) {
+	if (std::binary_search(MATERIAL_ATTRIBUTE_BLACKLIST.begin(), MATERIAL_ATTRIBUTE_BLACKLIST.end(), key))
+		return true;
+#if PRT_VERSION_MAJOR > 1
+	if (std::binary_search(MATERIAL_ATTRIBUTE_BLACKLIST_PBR.begin(), MATERIAL_ATTRIBUTE_BLACKLIST_PBR.end(), key))
+		return true;
+#endif
+	return false;
+}
@@ -18,6 +18,7 @@
  */
 
 #include "encoder/IMayaCallbacks.h"
+#include "encoder/MaterialAttributeBlacklist.h"
 #include "encoder/MayaEncoder.h"
 #include "encoder/TextureEncoder.h"
 
@@ -39,13 +40,14 @@
 #include "prt/prt.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <iostream>
 #include <limits>
 #include <memory>
 #include <numeric>
-#include <set>
 #include <sstream>
+#include <string_view>
 #include <vector>
 
 // PRT version < 2.1
@@ -102,6 +104,16 @@ std::pair<std::vector<const T*>, std::vector<size_t>> toPtrVec(const std::vector
 	return std::make_pair(pv, ps);
 }
 
+// lets aliased uv sets point to the arrays of their source set
+template <typename T>
+void applyUVSetSources(std::pair<std::vector<const T*>, std::vector<size_t>>& pv,
+                       const std::vector<uint32_t>& uvSetSources) {
+	for (size_t uvSet = 0; uvSet < uvSetSources.size(); uvSet++) {
+		pv.first[uvSet] = pv.first[uvSetSources[uvSet]];
+		pv.second[uvSet] = pv.second[uvSetSources[uvSet]];
+	}
+}
+
 template <typename C, typename FUNC, typename OBJ, typename... ARGS>
 std::basic_string<C> callAPI(FUNC f, OBJ& obj, ARGS&&... args) {
 	std::vector<C> buffer(1024, 0x0);
@@ -171,102 +183,46 @@ std::wstring getTexturePath(const prtx::TexturePtr& texture, IMayaCallbacks* cal
 	return {};
 }
 
-// we blacklist all CGA-style material attribute keys, see prtx/Material.h
-const std::set<std::wstring> MATERIAL_ATTRIBUTE_BLACKLIST = {
-        L"ambient.b",
-        L"ambient.g",
-        L"ambient.r",
-        L"bumpmap.rw",
-        L"bumpmap.su",
-        L"bumpmap.sv",
-        L"bumpmap.tu",
-        L"bumpmap.tv",
-        L"color.a",
-        L"color.b",
-        L"color.g",
-        L"color.r",
-        L"color.rgb",
-        L"colormap.rw",
-        L"colormap.su",
-        L"colormap.sv",
-        L"colormap.tu",
-        L"colormap.tv",
-        L"dirtmap.rw",
-        L"dirtmap.su",
-        L"dirtmap.sv",
-        L"dirtmap.tu",
-        L"dirtmap.tv",
-        L"normalmap.rw",
-        L"normalmap.su",
-        L"normalmap.sv",
-        L"normalmap.tu",
-        L"normalmap.tv",
-        L"opacitymap.rw",
-        L"opacitymap.su",
-        L"opacitymap.sv",
-        L"opacitymap.tu",
-        L"opacitymap.tv",
-        L"specular.b",
-        L"specular.g",
-        L"specular.r",
-        L"specularmap.rw",
-        L"specularmap.su",
-        L"specularmap.sv",
-        L"specularmap.tu",
-        L"specularmap.tv",
-        L"bumpmap",
-        L"colormap",
-        L"dirtmap",
-        L"normalmap",
-        L"opacitymap",
-        L"opacitymap.mode",
-        L"specularmap"
-
-#if PRT_VERSION_MAJOR > 1
-        // also blacklist CGA-style PBR attrs from CE 2019.0, PRT 2.x
-        ,
-        L"emissive.b",
-        L"emissive.g",
-        L"emissive.r",
-        L"emissivemap.rw",
-        L"emissivemap.su",
-        L"emissivemap.sv",
-        L"emissivemap.tu",
-        L"emissivemap.tv",
-        L"metallicmap.rw",
-        L"metallicmap.su",
-        L"metallicmap.sv",
-        L"metallicmap.tu",
-        L"metallicmap.tv",
-        L"occlusionmap.rw",
-        L"occlusionmap.su",
-        L"occlusionmap.sv",
-        L"occlusionmap.tu",
-        L"occlusionmap.tv",
-        L"roughnessmap.rw",
-        L"roughnessmap.su",
-        L"roughnessmap.sv",
-        L"roughnessmap.tu",
-        L"roughnessmap.tv",
-        L"emissivemap",
-        L"metallicmap",
-        L"occlusionmap",
-        L"roughnessmap"
-#endif
+// the keys of a material which are passed on, together with their types
+// most materials of a generate call share the same keys, so the plan is only rebuilt if the keys change
+class MaterialConversionPlan {
+public:
+	struct Entry {
+		size_t keyIndex;
+		prt::Attributable::PrimitiveType type;
+	};
+
+	const std::vector<Entry>& get(const prtx::Material& material, const prtx::WStringVector& keys) {
+		if (!mValid || (keys != mKeys)) {
+			mKeys = keys;
+			mEntries.clear();
+			for (size_t k = 0; k < keys.size(); k++) {
+				if (!isBlacklisted(keys[k]))
+					mEntries.push_back({k, material.getType(keys[k])});
+			}
+			mValid = true;
+		}
+		return mEntries;
+	}
+
+private:
+	bool mValid = false;
+	prtx::WStringVector mKeys;
+	std::vector<Entry> mEntries;
 };
 
 void convertMaterialToAttributeMap(prtx::PRTUtils::AttributeMapBuilderPtr& aBuilder, const prtx::Material& prtxAttr,
-                                   const prtx::WStringVector& keys, IMayaCallbacks* cb, prt::Cache* cache) {
+                                   const prtx::WStringVector& keys, MaterialConversionPlan& plan, IMayaCallbacks* cb,
+                                   prt::Cache* cache) {
 	if constexpr (DBG)
 		srl_log_debug(L"-- converting material: %1%") % prtxAttr.name();
-	for (const auto& key : keys) {
-		if (MATERIAL_ATTRIBUTE_BLACKLIST.count(key) > 0)
-			continue;
+	for (const MaterialConversionPlan::Entry& entry : plan.get(prtxAttr, keys)) {
+		const std::wstring& key = keys[entry.keyIndex];
 
 		if constexpr (DBG)
 			srl_log_debug(L"   key: %1%") % key;
 
-		switch (prtxAttr.getType(key)) {
+		switch (entry.type) {
 			case prt::Attributable::PT_BOOL:
 				aBuilder->setBool(key.c_str(), prtxAttr.getBool(key) == prtx::PRTX_TRUE);
 				break;
@@ -372,30 +328,34 @@ void forEachKey(prt::Attributable const* a, F f) {
 	}
 }
 
+// collects the final values of the initial shape's attributes on shape and passes them with a single callback
 void forwardGenericAttributes(IMayaCallbacks* hc, size_t initialShapeIndex, const prtx::InitialShape& initialShape,
                               const prtx::ShapePtr& shape) {
-	forEachKey(initialShape.getAttributeMap(),
-	           [&hc, &shape, &initialShapeIndex, &initialShape](prt::Attributable const* a, wchar_t const* key) {
-		           switch (shape->getType(key)) {
-			           case prtx::Attributable::PT_STRING: {
-				           const auto v = shape->getString(key);
-				           hc->attrString(initialShapeIndex, shape->getID(), key, v.c_str());
-				           break;
-			           }
-			           case prtx::Attributable::PT_FLOAT: {
-				           const auto v = shape->getFloat(key);
-				           hc->attrFloat(initialShapeIndex, shape->getID(), key, v);
-				           break;
-			           }
-			           case prtx::Attributable::PT_BOOL: {
-				           const auto v = shape->getBool(key);
-				           hc->attrBool(initialShapeIndex, shape->getID(), key, (v == prtx::PRTX_TRUE));
-				           break;
-			           }
-			           default:
-				           break;
-		           }
-	           });
+	prtx::PRTUtils::AttributeMapBuilderPtr amb(prt::AttributeMapBuilder::create());
+	forEachKey(initialShape.getAttributeMap(), [&amb, &shape](prt::Attributable const*, wchar_t const* key) {
+		switch (shape->getType(key)) {
+			case prtx::Attributable::PT_STRING: {
+				const auto v = shape->getString(key);
+				amb->setString(key, v.c_str());
+				break;
+			}
+			case prtx::Attributable::PT_FLOAT: {
+				const auto v = shape->getFloat(key);
+				amb->setFloat(key, v);
+				break;
+			}
+			case prtx::Attributable::PT_BOOL: {
+				const auto v = shape->getBool(key);
+				amb->setBool(key, (v == prtx::PRTX_TRUE));
+				break;
+			}
+			default:
+				break;
+		}
+	});
+
+	const prtx::PRTUtils::AttributeMapPtr attributes(amb->createAttributeMap());
+	hc->addAttributes(initialShapeIndex, shape->getID(), attributes.get());
 }
 
 using AttributeMapNOPtrVector = std::vector<const prt::AttributeMap*>;
@@ -452,6 +412,17 @@ private:
 		mVertexIndices.reserve(numIndices);
 		mNormalIndices.reserve(numIndices);
 
+		// a higher uv set without data of its own in all meshes would be a copy of uv set 0, alias it instead
+		mUVSetSources.assign(maxNumUVSets, 0u);
+		for (const auto& geo : geometries) {
+			for (const auto& mesh : geo->getMeshes()) {
+				for (uint32_t uvSet = 1; uvSet < mesh->getUVSetsCount(); uvSet++) {
+					if (!mesh->getUVCoords(uvSet).empty())
+						mUVSetSources[uvSet] = uvSet;
+				}
+			}
+		}
+
 		// Allocate memory for uvs
 		std::vector<uint32_t> numUvs(maxNumUVSets);
 		std::vector<uint32_t> numUvCounts(maxNumUVSets);
@@ -478,6 +449,8 @@ private:
 		mUvIndices.resize(maxNumUVSets);
 
 		for (uint32_t uvSet = 0; uvSet < maxNumUVSets; uvSet++) {
+			if (mUVSetSources[uvSet] != uvSet)
+				continue;
 			mUvs[uvSet].reserve(numUvs[uvSet]);
 			mUvCounts[uvSet].reserve(numUvCounts[uvSet]);
 			mUvIndices[uvSet].reserve(numUvIndices[uvSet]);
@@ -516,6 +489,9 @@ private:
 					srl_log_debug("-- mesh: numUVSets = %1%") % numUVSets;
 
 				for (uint32_t uvSet = 0; uvSet < mUvs.size(); uvSet++) {
+					if (mUVSetSources[uvSet] != uvSet)
+						continue;
+
 					// append texture coordinates
 					const prtx::DoubleVector& uvs = (uvSet < numUVSets) ? mesh->getUVCoords(uvSet) : EMPTY_UVS;
 					const auto& src = uvs.empty() ? uvs0 : uvs;
@@ -621,8 +597,45 @@ public:
 	std::vector<prtx::DoubleVector> mUvs;
 	std::vector<prtx::IndexVector> mUvCounts;
 	std::vector<prtx::IndexVector> mUvIndices;
+	std::vector<uint32_t> mUVSetSources; // the uv set holding the data of each uv set, the aliased sets stay empty
 };
 
+// appends the axis-aligned bounding box of all meshes of the geometry as 8 vertices and 6 outward facing quads
+bool appendBoundingBox(const prtx::GeometryPtr& geometry, prtx::DoubleVector& coords, std::vector<uint32_t>& counts,
+                       std::vector<uint32_t>& indices) {
+	std::array<double, 3> bbMin;
+	std::array<double, 3> bbMax;
+	bbMin.fill(std::numeric_limits<double>::max());
+	bbMax.fill(std::numeric_limits<double>::lowest());
+
+	for (const auto& mesh : geometry->getMeshes()) {
+		const prtx::DoubleVector& verts = mesh->getVertexCoords();
+		for (size_t i = 0; i + 2 < verts.size(); i += 3) {
+			for (size_t axis = 0; axis < 3; axis++) {
+				bbMin[axis] = std::min(bbMin[axis], verts[i + axis]);
+				bbMax[axis] = std::max(bbMax[axis], verts[i + axis]);
+			}
+		}
+	}
+	if (bbMin[0] > bbMax[0])
+		return false;
+
+	// bit 0, 1 and 2 of the corner index select the x, y and z coordinate of the box corner
+	const uint32_t base = static_cast<uint32_t>(coords.size() / 3);
+	for (uint32_t corner = 0; corner < 8; corner++) {
+		coords.push_back((corner & 1u) ? bbMax[0] : bbMin[0]);
+		coords.push_back((corner & 2u) ? bbMax[1] : bbMin[1]);
+		coords.push_back((corner & 4u) ? bbMax[2] : bbMin[2]);
+	}
+
+	constexpr std::array<uint32_t, 24> BOX_QUADS = {0, 4, 6, 2, 1, 3, 7, 5, 0, 1, 5, 4,
+	                                                2, 6, 7, 3, 0, 2, 3, 1, 4, 5, 7, 6};
+	for (const uint32_t corner : BOX_QUADS)
+		indices.push_back(base + corner);
+	counts.insert(counts.end(), 6, 4);
+	return true;
+}
+
 } // namespace
 
 MayaEncoder::MayaEncoder(const std::wstring& id, const prt::AttributeMap* options, prt::Callbacks* callbacks)
@@ -642,6 +655,8 @@ void MayaEncoder::init(prtx::GenerateContext&) {
 void MayaEncoder::encode(prtx::GenerateContext& context, size_t initialShapeIndex) {
 	const prtx::InitialShape& initialShape = *context.getInitialShape(initialShapeIndex);
 	auto* cb = dynamic_cast<IMayaCallbacks*>(getCallbacks());
+	if (cb->isCanceled(initialShapeIndex))
+		return;
 
 	const bool emitAttrs = getOptions()->getBool(EO_EMIT_ATTRIBUTES);
 
@@ -655,21 +670,33 @@ void MayaEncoder::encode(prtx::GenerateContext& context, size_t initialShapeInde
 	prtx::ReportingStrategyPtr reportsCollector{
 	        prtx::LeafShapeReportingStrategy::create(context, initialShapeIndex, reportsAccumulator)};
 	prtx::LeafIteratorPtr li = prtx::LeafIterator::create(context, initialShapeIndex);
+	prtx::ShapePtr lastShape;
 	for (prtx::ShapePtr shape = li->getNext(); shape; shape = li->getNext()) {
+		if (cb->isCanceled(initialShapeIndex))
+			return;
+
 		prtx::ReportsPtr r = reportsCollector->getReports(shape->getID());
 		encPrep->add(context.getCache(), shape, initialShape.getAttributeMap(), r);
-
-		// get final values of generic attributes
-		if (emitAttrs)
-			forwardGenericAttributes(cb, initialShapeIndex, initialShape, shape);
+		lastShape = shape;
 	}
 
+	// get final values of generic attributes, they only differ between the leaf shapes if set per shape
+	// and the last leaf shape wins like it did with one callback per leaf shape
+	if (emitAttrs && lastShape)
+		forwardGenericAttributes(cb, initialShapeIndex, initialShape, lastShape);
+
 	prtx::EncodePreparator::InstanceVector instances;
 	encPrep->fetchFinalizedInstances(instances, PREP_FLAGS);
-	convertGeometry(initialShape, instances, cb, context.getCache());
+	if (cb->isCanceled(initialShapeIndex))
+		return;
+
+	if (getOptions()->getBool(EO_BOUNDING_BOXES_ONLY))
+		convertBoundingBoxes(initialShapeIndex, initialShape, instances, cb, context.getCache());
+	else
+		convertGeometry(initialShapeIndex, initialShape, instances, cb, context.getCache());
 }
 
-void MayaEncoder::convertGeometry(const prtx::InitialShape& initialShape,
+void MayaEncoder::convertGeometry(size_t initialShapeIndex, const prtx::InitialShape& initialShape,
                                   const prtx::EncodePreparator::InstanceVector& instances, IMayaCallbacks* cb,
                                   prt::Cache* cache) {
 	if (instances.empty())
@@ -715,6 +742,7 @@ void MayaEncoder::convertGeometry(const prtx::InitialShape& initialShape,
 	auto matIt = materials.cbegin();
 	auto repIt = reports.cbegin();
 	prtx::PRTUtils::AttributeMapBuilderPtr amb(prt::AttributeMapBuilder::create());
+	MaterialConversionPlan materialPlan;
 	for (const auto& geo : geometries) {
 		const prtx::MeshPtrVector& meshes = geo->getMeshes();
 
@@ -725,7 +753,7 @@ void MayaEncoder::convertGeometry(const prtx::InitialShape& initialShape,
 			faceRanges.push_back(faceCount);
 
 			if (emitMaterials) {
-				convertMaterialToAttributeMap(amb, *(mat.get()), mat->getKeys(), cb, cache);
+				convertMaterialToAttributeMap(amb, *(mat.get()), mat->getKeys(), materialPlan, cb, cache);
 				matAttrMaps.v.push_back(amb->createAttributeMapAndReset());
 			}
 
@@ -751,10 +779,13 @@ void MayaEncoder::convertGeometry(const prtx::InitialShape& initialShape,
 	auto puvs = toPtrVec(sg.mUvs);
 	auto puvCounts = toPtrVec(sg.mUvCounts);
 	auto puvIndices = toPtrVec(sg.mUvIndices);
+	applyUVSetSources(puvs, sg.mUVSetSources);
+	applyUVSetSources(puvCounts, sg.mUVSetSources);
+	applyUVSetSources(puvIndices, sg.mUVSetSources);
 
-	cb->addMesh(initialShape.getName(), sg.mCoords.data(), sg.mCoords.size(), sg.mNormals.data(), sg.mNormals.size(),
-	            sg.mCounts.data(), sg.mCounts.size(), sg.mVertexIndices.data(), sg.mVertexIndices.size(),
-	            sg.mNormalIndices.data(), sg.mNormalIndices.size(),
+	cb->addMesh(initialShapeIndex, initialShape.getName(), sg.mCoords.data(), sg.mCoords.size(), sg.mNormals.data(),
+	            sg.mNormals.size(), sg.mCounts.data(), sg.mCounts.size(), sg.mVertexIndices.data(),
+	            sg.mVertexIndices.size(), sg.mNormalIndices.data(), sg.mNormalIndices.size(),
 
 	            puvs.first.data(), puvs.second.data(), puvCounts.first.data(), puvCounts.second.data(),
 	            puvIndices.first.data(), puvIndices.second.data(), sg.mUvs.size(),
@@ -766,6 +797,61 @@ void MayaEncoder::convertGeometry(const prtx::InitialShape& initialShape,
 		srl_log_debug(L"MayaEncoder::convertGeometry: end");
 }
 
+// cheap preview of the generated model, one box per instance with the instance's first material and reports
+void MayaEncoder::convertBoundingBoxes(size_t initialShapeIndex, const prtx::InitialShape& initialShape,
+                                       const prtx::EncodePreparator::InstanceVector& instances, IMayaCallbacks* cb,
+                                       prt::Cache* cache) {
+	const bool emitMaterials = getOptions()->getBool(EO_EMIT_MATERIALS);
+	const bool emitReports = getOptions()->getBool(EO_EMIT_REPORTS);
+
+	prtx::DoubleVector coords;
+	std::vector<uint32_t> counts;
+	std::vector<uint32_t> indices;
+	std::vector<uint32_t> faceRanges;
+	std::vector<int32_t> shapeIDs;
+	AttributeMapNOPtrVectorOwner matAttrMaps;
+	AttributeMapNOPtrVectorOwner reportAttrMaps;
+
+	prtx::PRTUtils::AttributeMapBuilderPtr amb(prt::AttributeMapBuilder::create());
+	MaterialConversionPlan materialPlan;
+	prtx::MaterialPtr defaultMaterial;
+	for (const auto& inst : instances) {
+		const uint32_t faceCount = static_cast<uint32_t>(counts.size());
+		if (!appendBoundingBox(inst.getGeometry(), coords, counts, indices))
+			continue;
+
+		faceRanges.push_back(faceCount);
+		shapeIDs.push_back(inst.getShapeId());
+
+		if (emitMaterials) {
+			// instances without materials get the default material, like the meshes of convertGeometry
+			const prtx::MaterialPtrVector& mats = inst.getMaterials();
+			if (mats.empty() && !defaultMaterial)
+				defaultMaterial = prtx::MaterialBuilder().createShared();
+			const prtx::MaterialPtr& mat = mats.empty() ? defaultMaterial : mats.front();
+			convertMaterialToAttributeMap(amb, *(mat.get()), mat->getKeys(), materialPlan, cb, cache);
+			matAttrMaps.v.push_back(amb->createAttributeMapAndReset());
+		}
+
+		if (emitReports) {
+			convertReportsToAttributeMap(amb, inst.getReports());
+			reportAttrMaps.v.push_back(amb->createAttributeMapAndReset());
+		}
+	}
+
+	if (counts.empty())
+		return;
+	faceRanges.push_back(static_cast<uint32_t>(counts.size())); // close last range
+
+	cb->addMesh(initialShapeIndex, initialShape.getName(), coords.data(), coords.size(), nullptr, 0, counts.data(),
+	            counts.size(), indices.data(), indices.size(), nullptr, 0,
+
+	            nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, 0,
+
+	            faceRanges.data(), faceRanges.size(), matAttrMaps.v.empty() ? nullptr : matAttrMaps.v.data(),
+	            reportAttrMaps.v.empty() ? nullptr : reportAttrMaps.v.data(), shapeIDs.data());
+}
+
 void MayaEncoder::finish(prtx::GenerateContext& /*context*/) {}
 
 MayaEncoderFactory* MayaEncoderFactory::createInstance() {
@@ -780,6 +866,7 @@ MayaEncoderFactory* MayaEncoderFactory::createInstance() {
 	amb->setBool(EO_EMIT_ATTRIBUTES, prtx::PRTX_TRUE);
 	amb->setBool(EO_EMIT_MATERIALS, prtx::PRTX_TRUE);
 	amb->setBool(EO_EMIT_REPORTS, prtx::PRTX_FALSE);
+	amb->setBool(EO_BOUNDING_BOXES_ONLY, prtx::PRTX_FALSE);
 	encoderInfoBuilder.setDefaultOptions(amb->createAttributeMap());
 
 	return new MayaEncoderFactory(encoderInfoBuilder.create());
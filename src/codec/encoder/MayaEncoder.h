@@ -49,9 +49,12 @@ public:
 	void finish(prtx::GenerateContext& context) override;
 
 private:
-	void convertGeometry(const prtx::InitialShape& initialShape,
+	void convertGeometry(size_t initialShapeIndex, const prtx::InitialShape& initialShape,
 	                     const prtx::EncodePreparator::InstanceVector& instances, IMayaCallbacks* callbacks,
 	                     prt::Cache* cache);
+	void convertBoundingBoxes(size_t initialShapeIndex, const prtx::InitialShape& initialShape,
+	                          const prtx::EncodePreparator::InstanceVector& instances, IMayaCallbacks* callbacks,
+	                          prt::Cache* cache);
 };
 
 class MayaEncoderFactory : public prtx::EncoderFactory, public prtx::Singleton<MayaEncoderFactory> {
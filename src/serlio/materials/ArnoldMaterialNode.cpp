@@ -44,9 +44,54 @@ const MELVariable MEL_VAR_ROUGHNESSMAP_BLEND_NODE(L"roughnessMapBlendNode");
 const MELVariable MEL_VAR_METALLICMAP_BLEND_NODE(L"metallicMapBlendNode");
 const MELVariable MEL_VAR_UV_TRAFO_NODE(L"uvTrafoNode");
 
-void setUvTransformAttrs(MELScriptBuilder& sb, const std::wstring& uvSet, const MaterialTrafo& trafo) {
-	sb.setAttr(MEL_VAR_UV_TRAFO_NODE, L"uvset", MELStringLiteral(uvSet));
-	sb.setAttr(MEL_VAR_UV_TRAFO_NODE, L"pivotFrame", 0.0, 0.0);
+// maps present in a material, materials with the same maps share the topology of their shading network
+enum NetworkMap : uint32_t {
+	COLOR_MAP = 1u << 0u,
+	BUMP_MAP = 1u << 1u,
+	DIRT_MAP = 1u << 2u,
+	SPECULAR_MAP = 1u << 3u,
+	OPACITY_MAP = 1u << 4u,
+	NORMAL_MAP = 1u << 5u,
+	EMISSIVE_MAP = 1u << 6u,
+	ROUGHNESS_MAP = 1u << 7u,
+	METALLIC_MAP = 1u << 8u
+};
+
+uint32_t getNetworkTopology(const MaterialInfo& matInfo) {
+	uint32_t topology = 0;
+	topology |= matInfo.colormap.empty() ? 0 : COLOR_MAP;
+	topology |= matInfo.bumpMap.empty() ? 0 : BUMP_MAP;
+	topology |= matInfo.dirtmap.empty() ? 0 : DIRT_MAP;
+	topology |= matInfo.specularMap.empty() ? 0 : SPECULAR_MAP;
+	topology |= matInfo.opacityMap.empty() ? 0 : OPACITY_MAP;
+	topology |= matInfo.normalMap.empty() ? 0 : NORMAL_MAP;
+	topology |= matInfo.emissiveMap.empty() ? 0 : EMISSIVE_MAP;
+	topology |= matInfo.roughnessMap.empty() ? 0 : ROUGHNESS_MAP;
+	topology |= matInfo.metallicMap.empty() ? 0 : METALLIC_MAP;
+	return topology;
+}
+
+MELVariable getTemplateShaderVariable(uint32_t topology) {
+	return MELVariable(L"serlioArnoldTemplate" + std::to_wstring(topology));
+}
+
+// creates a node of the shading network and connects it to its destination, or, if the network has been duplicated
+// from a template, looks up the node copy upstream of the destination and renames it
+void createOrFindNode(MELScriptBuilder& sb, bool duplicated, const std::wstring& nodeType, const MELVariable& node,
+                      const std::wstring& nodeName, const std::wstring& srcAttr, const MELVariable& dstNode,
+                      const std::wstring& dstAttr) {
+	if (duplicated) {
+		sb.getSourceNode(dstNode, dstAttr, node);
+		sb.rename(node, MELStringLiteral(nodeName));
+	}
+	else {
+		sb.setVar(node, MELStringLiteral(nodeName));
+		sb.createShader(nodeType, node);
+		sb.connectAttr(node, srcAttr, dstNode, dstAttr);
+	}
+}
+
+void setUvTransformAttrs(MELScriptBuilder& sb, const MaterialTrafo& trafo) {
 	sb.setAttr(MEL_VAR_UV_TRAFO_NODE, L"scaleFrame", 1.0 / trafo.su(), 1.0 / trafo.sv());
 	sb.setAttr(MEL_VAR_UV_TRAFO_NODE, L"translateFrame", -trafo.tu() / trafo.su(), -trafo.tv() / trafo.sv());
 	if (trafo.rw() != 0.0) {
@@ -54,32 +99,45 @@ void setUvTransformAttrs(MELScriptBuilder& sb, const std::wstring& uvSet, const
 	}
 }
 
-void createMapShader(MELScriptBuilder& sb, const std::string& tex, const MaterialTrafo& mapTrafo,
-                     const std::wstring& shaderName, const std::wstring& uvSet, const bool raw, const bool alpha) {
+void createMapShader(MELScriptBuilder& sb, bool duplicated, const std::string& tex, const MaterialTrafo& mapTrafo,
+                     const std::wstring& shaderName, const std::wstring& uvSet, const bool raw, const bool alpha,
+                     const std::wstring& srcAttr, const MELVariable& dstNode, const std::wstring& dstAttr) {
 	std::filesystem::path texPath(tex);
 	const std::wstring nodeName = prtu::cleanNameForMaya(texPath.stem().wstring());
-	sb.setVar(MEL_VAR_MAP_NODE, MELStringLiteral(nodeName));
+	const std::wstring passthroughAttr = alpha ? L"passthroughR" : L"passthrough";
 
-	sb.setVar(MEL_VAR_MAP_FILE, MELStringLiteral(prtu::toUTF16FromOSNarrow(tex)));
-	sb.createTextureShadingNode(MEL_VAR_MAP_NODE);
-	sb.setAttr(MEL_VAR_MAP_NODE, L"fileTextureName", MEL_VAR_MAP_FILE);
+	if (duplicated) {
+		sb.getSourceNode(dstNode, dstAttr, MEL_VAR_UV_TRAFO_NODE);
+		sb.rename(MEL_VAR_UV_TRAFO_NODE, MELStringLiteral(shaderName + L"_trafo"));
+		sb.getSourceNode(MEL_VAR_UV_TRAFO_NODE, passthroughAttr, MEL_VAR_MAP_NODE);
+		sb.rename(MEL_VAR_MAP_NODE, MELStringLiteral(nodeName));
+	}
+	else {
+		sb.setVar(MEL_VAR_MAP_NODE, MELStringLiteral(nodeName));
+		sb.createTextureShadingNode(MEL_VAR_MAP_NODE);
+
+		if (raw) {
+			sb.setAttr(MEL_VAR_MAP_NODE, L"colorSpace", MELStringLiteral(L"Raw"));
+			sb.setAttr(MEL_VAR_MAP_NODE, L"ignoreColorSpaceFileRules", true);
+		}
 
-	if (raw) {
-		sb.setAttr(MEL_VAR_MAP_NODE, L"colorSpace", MELStringLiteral(L"Raw"));
-		sb.setAttr(MEL_VAR_MAP_NODE, L"ignoreColorSpaceFileRules", true);
+		sb.setVar(MEL_VAR_UV_TRAFO_NODE, MELStringLiteral(shaderName + L"_trafo"));
+		sb.createShader(L"aiUvTransform", MEL_VAR_UV_TRAFO_NODE);
+		sb.setAttr(MEL_VAR_UV_TRAFO_NODE, L"uvset", MELStringLiteral(uvSet));
+		sb.setAttr(MEL_VAR_UV_TRAFO_NODE, L"pivotFrame", 0.0, 0.0);
+
+		sb.connectAttr(MEL_VAR_MAP_NODE, alpha ? L"outAlpha" : L"outColor", MEL_VAR_UV_TRAFO_NODE, passthroughAttr);
+		sb.connectAttr(MEL_VAR_UV_TRAFO_NODE, srcAttr, dstNode, dstAttr);
 	}
 
-	sb.setVar(MEL_VAR_UV_TRAFO_NODE, MELStringLiteral(shaderName + L"_trafo"));
-	sb.createShader(L"aiUvTransform", MEL_VAR_UV_TRAFO_NODE);
-	setUvTransformAttrs(sb, uvSet, mapTrafo);
+	sb.setVar(MEL_VAR_MAP_FILE, MELStringLiteral(prtu::toUTF16FromOSNarrow(tex)));
+	sb.setAttr(MEL_VAR_MAP_NODE, L"fileTextureName", MEL_VAR_MAP_FILE);
+	setUvTransformAttrs(sb, mapTrafo);
 
 	if (alpha) {
-		sb.connectAttr(MEL_VAR_MAP_NODE, L"outAlpha", MEL_VAR_UV_TRAFO_NODE, L"passthroughR");
 		sb.forceValidTextureAlphaChannel(MEL_VAR_MAP_NODE);
 		sb.setAttr(MEL_VAR_MAP_NODE, L"alphaIsLuminance", !MaterialUtils::textureHasAlphaChannel(texPath.wstring()));
 	}
-	else
-		sb.connectAttr(MEL_VAR_MAP_NODE, L"outColor", MEL_VAR_UV_TRAFO_NODE, L"passthrough");
 }
 
 } // namespace
@@ -94,6 +152,9 @@ MStatus ArnoldMaterialNode::initialize() {
 }
 
 void ArnoldMaterialNode::declareMaterialStrings(MELScriptBuilder& sb) {
+	// a new script starts, templates of previous scripts are not known to it
+	mTemplateTopologies.clear();
+
 	sb.declString(MEL_VAR_SHADER_NODE);
 	sb.declString(MEL_VAR_MAP_FILE);
 	sb.declString(MEL_VAR_MAP_NODE);
@@ -114,25 +175,40 @@ void ArnoldMaterialNode::declareMaterialStrings(MELScriptBuilder& sb) {
 void ArnoldMaterialNode::appendToMaterialScriptBuilder(MELScriptBuilder& sb, const MaterialInfo& matInfo,
                                                        const std::wstring& shaderBaseName,
                                                        const std::wstring& shadingEngineName) {
+	// the first network of each topology is built node by node and serves as template, further networks with the
+	// same topology are duplicated from it and only get their parameters set
+	const uint32_t topology = getNetworkTopology(matInfo);
+	const MELVariable templateShader = getTemplateShaderVariable(topology);
+	const bool duplicated = (mTemplateTopologies.count(topology) > 0);
+
 	// create shader
-	sb.setVar(MEL_VAR_SHADER_NODE, MELStringLiteral(shaderBaseName));
 	sb.setVar(MEL_VARIABLE_SHADING_ENGINE, MELStringLiteral(shadingEngineName));
-	sb.createShader(L"aiStandardSurface", MEL_VAR_SHADER_NODE); // note: name might change to be unique
+	if (duplicated) {
+		sb.duplicateUpstream(templateShader, MEL_VAR_SHADER_NODE);
+		sb.rename(MEL_VAR_SHADER_NODE, MELStringLiteral(shaderBaseName));
+	}
+	else {
+		sb.setVar(MEL_VAR_SHADER_NODE, MELStringLiteral(shaderBaseName));
+		sb.createShader(L"aiStandardSurface", MEL_VAR_SHADER_NODE); // note: name might change to be unique
+		sb.setAttr(MEL_VAR_SHADER_NODE, L"base", 1.0);
+		sb.setAttr(MEL_VAR_SHADER_NODE, L"specular", 1.0); // reflectivity
+		sb.setAttr(MEL_VAR_SHADER_NODE, L"emission", 1.0);
+
+		sb.declString(templateShader);
+		sb.setVar(templateShader, MEL_VAR_SHADER_NODE);
+		mTemplateTopologies.insert(topology);
+	}
 
 	// connect to shading group
 	sb.connectAttr(MEL_VAR_SHADER_NODE, L"outColor", MEL_VARIABLE_SHADING_ENGINE, L"surfaceShader");
 
-	sb.setAttr(MEL_VAR_SHADER_NODE, L"base", 1.0);
-
 	// color/dirt map multiply node
-	sb.setVar(MEL_VAR_DIRTMAP_BLEND_NODE, MELStringLiteral(shadingEngineName + L"_dirt_multiply"));
-	sb.createShader(L"aiMultiply", MEL_VAR_DIRTMAP_BLEND_NODE);
-	sb.connectAttr(MEL_VAR_DIRTMAP_BLEND_NODE, L"outColor", MEL_VAR_SHADER_NODE, L"baseColor");
+	createOrFindNode(sb, duplicated, L"aiMultiply", MEL_VAR_DIRTMAP_BLEND_NODE, shadingEngineName + L"_dirt_multiply",
+	                 L"outColor", MEL_VAR_SHADER_NODE, L"baseColor");
 
 	// color/color map multiply node
-	sb.setVar(MEL_VAR_COLOR_MAP_BLEND_NODE, MELStringLiteral(shadingEngineName + L"_color_map_blend"));
-	sb.createShader(L"aiMultiply", MEL_VAR_COLOR_MAP_BLEND_NODE);
-	sb.connectAttr(MEL_VAR_COLOR_MAP_BLEND_NODE, L"outColor", MEL_VAR_DIRTMAP_BLEND_NODE, L"input1");
+	createOrFindNode(sb, duplicated, L"aiMultiply", MEL_VAR_COLOR_MAP_BLEND_NODE,
+	                 shadingEngineName + L"_color_map_blend", L"outColor", MEL_VAR_DIRTMAP_BLEND_NODE, L"input1");
 
 	// color
 	sb.setAttr(MEL_VAR_COLOR_MAP_BLEND_NODE, L"input1", matInfo.diffuseColor);
@@ -143,26 +219,24 @@ void ArnoldMaterialNode::appendToMaterialScriptBuilder(MELScriptBuilder& sb, con
 	}
 	else {
 		std::wstring shaderName = shadingEngineName + L"_color_map";
-		createMapShader(sb, matInfo.colormap, matInfo.colormapTrafo, shaderName, L"map1", false, false);
-		sb.connectAttr(MEL_VAR_UV_TRAFO_NODE, L"outColor", MEL_VAR_COLOR_MAP_BLEND_NODE, L"input2");
+		createMapShader(sb, duplicated, matInfo.colormap, matInfo.colormapTrafo, shaderName, L"map1", false, false,
+		                L"outColor", MEL_VAR_COLOR_MAP_BLEND_NODE, L"input2");
 	}
 
 	// bump map
-	sb.setVar(MEL_VAR_BUMP_VALUE_NODE, MELStringLiteral(shadingEngineName + L"_bump_value"));
-	sb.createShader(L"bump2d", MEL_VAR_BUMP_VALUE_NODE);
-	sb.connectAttr(MEL_VAR_BUMP_VALUE_NODE, L"outNormal", MEL_VAR_SHADER_NODE, L"normalCamera");
+	createOrFindNode(sb, duplicated, L"bump2d", MEL_VAR_BUMP_VALUE_NODE, shadingEngineName + L"_bump_value",
+	                 L"outNormal", MEL_VAR_SHADER_NODE, L"normalCamera");
 
 	if (matInfo.bumpMap.empty()) {
 		sb.setAttr(MEL_VAR_BUMP_VALUE_NODE, L"bumpValue", 0.0);
 	}
 	else {
-		std::wstring shaderName = shadingEngineName + L"_bump_map";
-		createMapShader(sb, matInfo.bumpMap, matInfo.bumpmapTrafo, shaderName, L"bumpMap", true, false);
+		createOrFindNode(sb, duplicated, L"luminance", MEL_VAR_BUMP_LUMINANCE_NODE,
+		                 shadingEngineName + L"_bump_luminance", L"outValue", MEL_VAR_BUMP_VALUE_NODE, L"bumpValue");
 
-		sb.setVar(MEL_VAR_BUMP_LUMINANCE_NODE, MELStringLiteral(shadingEngineName + L"_bump_luminance"));
-		sb.createShader(L"luminance", MEL_VAR_BUMP_LUMINANCE_NODE);
-		sb.connectAttr(MEL_VAR_UV_TRAFO_NODE, L"outColor", MEL_VAR_BUMP_LUMINANCE_NODE, L"value");
-		sb.connectAttr(MEL_VAR_BUMP_LUMINANCE_NODE, L"outValue", MEL_VAR_BUMP_VALUE_NODE, L"bumpValue");
+		std::wstring shaderName = shadingEngineName + L"_bump_map";
+		createMapShader(sb, duplicated, matInfo.bumpMap, matInfo.bumpmapTrafo, shaderName, L"bumpMap", true, false,
+		                L"outColor", MEL_VAR_BUMP_LUMINANCE_NODE, L"value");
 	}
 
 	// dirt map
@@ -171,17 +245,13 @@ void ArnoldMaterialNode::appendToMaterialScriptBuilder(MELScriptBuilder& sb, con
 	}
 	else {
 		std::wstring shaderName = shadingEngineName + L"_dirt_map";
-		createMapShader(sb, matInfo.dirtmap, matInfo.dirtmapTrafo, shaderName, L"dirtMap", false, false);
-		sb.connectAttr(MEL_VAR_UV_TRAFO_NODE, L"outColor", MEL_VAR_DIRTMAP_BLEND_NODE, L"input2");
+		createMapShader(sb, duplicated, matInfo.dirtmap, matInfo.dirtmapTrafo, shaderName, L"dirtMap", false, false,
+		                L"outColor", MEL_VAR_DIRTMAP_BLEND_NODE, L"input2");
 	}
 
-	// reflectivity
-	sb.setAttr(MEL_VAR_SHADER_NODE, L"specular", 1.0);
-
 	// specular/specular map multiply node
-	sb.setVar(MEL_VAR_SPECULARMAP_BLEND_NODE, MELStringLiteral(shadingEngineName + L"_specular_map_blend"));
-	sb.createShader(L"aiMultiply", MEL_VAR_SPECULARMAP_BLEND_NODE);
-	sb.connectAttr(MEL_VAR_SPECULARMAP_BLEND_NODE, L"outColor", MEL_VAR_SHADER_NODE, L"specularColor");
+	createOrFindNode(sb, duplicated, L"aiMultiply", MEL_VAR_SPECULARMAP_BLEND_NODE,
+	                 shadingEngineName + L"_specular_map_blend", L"outColor", MEL_VAR_SHADER_NODE, L"specularColor");
 
 	// ignore the specular color for now (matInfo.specularColor), since in the metallic-roughness
 	// model of glTF specularity is controlled entirely via the roughness which requires the specular
@@ -195,16 +265,17 @@ void ArnoldMaterialNode::appendToMaterialScriptBuilder(MELScriptBuilder& sb, con
 	}
 	else {
 		std::wstring shaderName = shadingEngineName + L"_specular_map";
-		createMapShader(sb, matInfo.specularMap, matInfo.specularmapTrafo, shaderName, L"specularMap", false, false);
-		sb.connectAttr(MEL_VAR_UV_TRAFO_NODE, L"outColor", MEL_VAR_SPECULARMAP_BLEND_NODE, L"input2");
+		createMapShader(sb, duplicated, matInfo.specularMap, matInfo.specularmapTrafo, shaderName, L"specularMap",
+		                false, false, L"outColor", MEL_VAR_SPECULARMAP_BLEND_NODE, L"input2");
 	}
 
 	// opacity/opacity map multiply node
-	sb.setVar(MEL_VAR_OPACITYMAP_BLEND_NODE, MELStringLiteral(shadingEngineName + L"_opacity_map_blend"));
-	sb.createShader(L"aiMultiply", MEL_VAR_OPACITYMAP_BLEND_NODE);
-	sb.connectAttr(MEL_VAR_OPACITYMAP_BLEND_NODE, L"outColorR", MEL_VAR_SHADER_NODE, L"opacityR");
-	sb.connectAttr(MEL_VAR_OPACITYMAP_BLEND_NODE, L"outColorR", MEL_VAR_SHADER_NODE, L"opacityG");
-	sb.connectAttr(MEL_VAR_OPACITYMAP_BLEND_NODE, L"outColorR", MEL_VAR_SHADER_NODE, L"opacityB");
+	createOrFindNode(sb, duplicated, L"aiMultiply", MEL_VAR_OPACITYMAP_BLEND_NODE,
+	                 shadingEngineName + L"_opacity_map_blend", L"outColorR", MEL_VAR_SHADER_NODE, L"opacityR");
+	if (!duplicated) {
+		sb.connectAttr(MEL_VAR_OPACITYMAP_BLEND_NODE, L"outColorR", MEL_VAR_SHADER_NODE, L"opacityG");
+		sb.connectAttr(MEL_VAR_OPACITYMAP_BLEND_NODE, L"outColorR", MEL_VAR_SHADER_NODE, L"opacityB");
+	}
 
 	// opacity
 	sb.setAttr(MEL_VAR_OPACITYMAP_BLEND_NODE, L"input1R", matInfo.opacity);
@@ -215,28 +286,26 @@ void ArnoldMaterialNode::appendToMaterialScriptBuilder(MELScriptBuilder& sb, con
 	}
 	else {
 		std::wstring shaderName = shadingEngineName + L"_opacity_map";
-		createMapShader(sb, matInfo.opacityMap, matInfo.opacitymapTrafo, shaderName, L"opacityMap", false, true);
-		sb.connectAttr(MEL_VAR_UV_TRAFO_NODE, L"outColorR", MEL_VAR_OPACITYMAP_BLEND_NODE, L"input2R");
+		createMapShader(sb, duplicated, matInfo.opacityMap, matInfo.opacitymapTrafo, shaderName, L"opacityMap", false,
+		                true, L"outColorR", MEL_VAR_OPACITYMAP_BLEND_NODE, L"input2R");
 	}
 
 	// normal map
 	if (!matInfo.normalMap.empty()) {
+		createOrFindNode(sb, duplicated, L"aiNormalMap", MEL_VAR_NORMAL_MAP_CONVERT_NODE,
+		                 shadingEngineName + L"_normal_map_convert", L"outValue", MEL_VAR_BUMP_VALUE_NODE,
+		                 L"normalCamera");
+		if (!duplicated)
+			sb.setAttr(MEL_VAR_NORMAL_MAP_CONVERT_NODE, L"colorToSigned", true);
+
 		std::wstring shaderName = shadingEngineName + L"_normal_map";
-		createMapShader(sb, matInfo.normalMap, matInfo.normalmapTrafo, shaderName, L"normalMap", true, false);
-		sb.setVar(MEL_VAR_NORMAL_MAP_CONVERT_NODE, MELStringLiteral(shadingEngineName + L"_normal_map_convert"));
-		sb.createShader(L"aiNormalMap", MEL_VAR_NORMAL_MAP_CONVERT_NODE);
-		sb.setAttr(MEL_VAR_NORMAL_MAP_CONVERT_NODE, L"colorToSigned", true);
-		sb.connectAttr(MEL_VAR_UV_TRAFO_NODE, L"outColor", MEL_VAR_NORMAL_MAP_CONVERT_NODE, L"input");
-		sb.connectAttr(MEL_VAR_NORMAL_MAP_CONVERT_NODE, L"outValue", MEL_VAR_BUMP_VALUE_NODE, L"normalCamera");
+		createMapShader(sb, duplicated, matInfo.normalMap, matInfo.normalmapTrafo, shaderName, L"normalMap", true,
+		                false, L"outColor", MEL_VAR_NORMAL_MAP_CONVERT_NODE, L"input");
 	}
 
-	// emission
-	sb.setAttr(MEL_VAR_SHADER_NODE, L"emission", 1.0);
-
 	// emission/emissive map multiply node
-	sb.setVar(MEL_VAR_EMISSIVEMAP_BLEND_NODE, MELStringLiteral(shadingEngineName + L"_emissive_map_blend"));
-	sb.createShader(L"aiMultiply", MEL_VAR_EMISSIVEMAP_BLEND_NODE);
-	sb.connectAttr(MEL_VAR_EMISSIVEMAP_BLEND_NODE, L"outColor", MEL_VAR_SHADER_NODE, L"emissionColor");
+	createOrFindNode(sb, duplicated, L"aiMultiply", MEL_VAR_EMISSIVEMAP_BLEND_NODE,
+	                 shadingEngineName + L"_emissive_map_blend", L"outColor", MEL_VAR_SHADER_NODE, L"emissionColor");
 
 	// emissive color
 	sb.setAttr(MEL_VAR_EMISSIVEMAP_BLEND_NODE, L"input1", matInfo.emissiveColor);
@@ -247,14 +316,14 @@ void ArnoldMaterialNode::appendToMaterialScriptBuilder(MELScriptBuilder& sb, con
 	}
 	else {
 		std::wstring shaderName = shadingEngineName + L"_emissive_map";
-		createMapShader(sb, matInfo.emissiveMap, matInfo.emissivemapTrafo, shaderName, L"emissiveMap", false, false);
-		sb.connectAttr(MEL_VAR_UV_TRAFO_NODE, L"outColor", MEL_VAR_EMISSIVEMAP_BLEND_NODE, L"input2");
+		createMapShader(sb, duplicated, matInfo.emissiveMap, matInfo.emissivemapTrafo, shaderName, L"emissiveMap",
+		                false, false, L"outColor", MEL_VAR_EMISSIVEMAP_BLEND_NODE, L"input2");
 	}
 
 	// roughness/roughness map multiply node
-	sb.setVar(MEL_VAR_ROUGHNESSMAP_BLEND_NODE, MELStringLiteral(shadingEngineName + L"_roughness_map_blend"));
-	sb.createShader(L"aiMultiply", MEL_VAR_ROUGHNESSMAP_BLEND_NODE);
-	sb.connectAttr(MEL_VAR_ROUGHNESSMAP_BLEND_NODE, L"outColorR", MEL_VAR_SHADER_NODE, L"specularRoughness");
+	createOrFindNode(sb, duplicated, L"aiMultiply", MEL_VAR_ROUGHNESSMAP_BLEND_NODE,
+	                 shadingEngineName + L"_roughness_map_blend", L"outColorR", MEL_VAR_SHADER_NODE,
+	                 L"specularRoughness");
 
 	// roughness
 	sb.setAttr(MEL_VAR_ROUGHNESSMAP_BLEND_NODE, L"input1R", matInfo.roughness);
@@ -264,17 +333,15 @@ void ArnoldMaterialNode::appendToMaterialScriptBuilder(MELScriptBuilder& sb, con
 		sb.setAttr(MEL_VAR_ROUGHNESSMAP_BLEND_NODE, L"input2R", 1.0);
 	}
 	else {
-		std::wstring shaderName = shadingEngineName + L"_roughness_map";
-		createMapShader(sb, matInfo.roughnessMap, matInfo.roughnessmapTrafo, shaderName, L"roughnessMap", true, false);
-
 		// in PRT the roughness map only uses the green channel
-		sb.connectAttr(MEL_VAR_UV_TRAFO_NODE, L"outColorG", MEL_VAR_ROUGHNESSMAP_BLEND_NODE, L"input2R");
+		std::wstring shaderName = shadingEngineName + L"_roughness_map";
+		createMapShader(sb, duplicated, matInfo.roughnessMap, matInfo.roughnessmapTrafo, shaderName, L"roughnessMap",
+		                true, false, L"outColorG", MEL_VAR_ROUGHNESSMAP_BLEND_NODE, L"input2R");
 	}
 
 	// metallic/metallic map multiply node
-	sb.setVar(MEL_VAR_METALLICMAP_BLEND_NODE, MELStringLiteral(shadingEngineName + L"_metallic_map_blend"));
-	sb.createShader(L"aiMultiply", MEL_VAR_METALLICMAP_BLEND_NODE);
-	sb.connectAttr(MEL_VAR_METALLICMAP_BLEND_NODE, L"outColorR", MEL_VAR_SHADER_NODE, L"metalness");
+	createOrFindNode(sb, duplicated, L"aiMultiply", MEL_VAR_METALLICMAP_BLEND_NODE,
+	                 shadingEngineName + L"_metallic_map_blend", L"outColorR", MEL_VAR_SHADER_NODE, L"metalness");
 
 	// metallic
 	sb.setAttr(MEL_VAR_METALLICMAP_BLEND_NODE, L"input1R", matInfo.metallic);
@@ -284,11 +351,10 @@ void ArnoldMaterialNode::appendToMaterialScriptBuilder(MELScriptBuilder& sb, con
 		sb.setAttr(MEL_VAR_METALLICMAP_BLEND_NODE, L"input2R", 1.0);
 	}
 	else {
-		std::wstring shaderName = shadingEngineName + L"_metallic_map";
-		createMapShader(sb, matInfo.metallicMap, matInfo.metallicmapTrafo, shaderName, L"metallicMap", true, false);
-
 		// in PRT the metallic map only uses the blue channel
-		sb.connectAttr(MEL_VAR_UV_TRAFO_NODE, L"outColorB", MEL_VAR_METALLICMAP_BLEND_NODE, L"input2R");
+		std::wstring shaderName = shadingEngineName + L"_metallic_map";
+		createMapShader(sb, duplicated, matInfo.metallicMap, matInfo.metallicmapTrafo, shaderName, L"metallicMap",
+		                true, false, L"outColorB", MEL_VAR_METALLICMAP_BLEND_NODE, L"input2R");
 	}
 }
 
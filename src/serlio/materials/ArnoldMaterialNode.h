@@ -21,6 +21,9 @@
 
 #include "MaterialNode.h"
 
+#include <cstdint>
+#include <set>
+
 class MaterialInfo;
 class MELScriptBuilder;
 
@@ -40,4 +43,7 @@ private:
 	MObject getInMesh() const override;
 	MObject getOutMesh() const override;
 	std::vector<std::string> getPluginDependencies() const override;
+
+	// topologies of the template networks available in the material script currently being built
+	std::set<uint32_t> mTemplateTopologies;
 };
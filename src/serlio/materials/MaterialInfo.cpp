@@ -19,46 +19,144 @@
 
 #include "materials/MaterialInfo.h"
 
-#include "MaterialInfo.h"
 #include "utils/Utilities.h"
+
 #include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <mutex>
 
 namespace {
 
-template <size_t N>
-void getDoubleArray(std::array<double, N>& array, adsk::Data::Handle& sHandle, const std::string& name) {
-	if (sHandle.setPositionByMemberName(name.c_str())) {
-		double* data = sHandle.asDouble();
-		if (sHandle.dataLength() >= N && data) {
-			std::copy(data, data + N, array.begin());
-			return;
+// material structure members read by MaterialInfo, in the declaration order of the MaterialInfo members
+enum MaterialMember : size_t {
+	BUMP_MAP,
+	COLOR_MAP,
+	DIRT_MAP,
+	EMISSIVE_MAP,
+	METALLIC_MAP,
+	NORMAL_MAP,
+	OCCLUSION_MAP,
+	OPACITY_MAP,
+	ROUGHNESS_MAP,
+	SPECULAR_MAP,
+	OPACITY,
+	METALLIC,
+	ROUGHNESS,
+	AMBIENT_COLOR,
+	DIFFUSE_COLOR,
+	EMISSIVE_COLOR,
+	SPECULAR_COLOR,
+	SPECULARMAP_TRAFO,
+	BUMPMAP_TRAFO,
+	COLORMAP_TRAFO,
+	DIRTMAP_TRAFO,
+	EMISSIVEMAP_TRAFO,
+	METALLICMAP_TRAFO,
+	NORMALMAP_TRAFO,
+	OCCLUSIONMAP_TRAFO,
+	OPACITYMAP_TRAFO,
+	ROUGHNESSMAP_TRAFO,
+	MATERIAL_MEMBER_COUNT
+};
+
+const std::array<const char*, MATERIAL_MEMBER_COUNT> MATERIAL_MEMBER_NAMES = {
+        "bumpMap",          "diffuseMap",       "diffuseMap1",       "emissiveMap",     "metallicMap",
+        "normalMap",        "occlusionMap",     "opacityMap",        "roughnessMap",    "specularMap",
+        "opacity",          "metallic",         "roughness",         "ambientColor",    "diffuseColor",
+        "emissiveColor",    "specularColor",    "specularmapTrafo",  "bumpmapTrafo",    "colormapTrafo",
+        "dirtmapTrafo",     "emissivemapTrafo", "metallicmapTrafo",  "normalmapTrafo",  "occlusionmapTrafo",
+        "opacitymapTrafo",  "roughnessmapTrafo"};
+
+constexpr unsigned int MISSING_MEMBER = std::numeric_limits<unsigned int>::max();
+using MemberIndexTable = std::array<unsigned int, MATERIAL_MEMBER_COUNT>;
+
+// the layout of a registered structure never changes, so the member names are only resolved once per structure
+const MemberIndexTable& getMemberIndexTable(const adsk::Data::Structure& structure) {
+	static std::mutex tablesMutex;
+	static std::map<const adsk::Data::Structure*, MemberIndexTable> tables;
+
+	std::lock_guard<std::mutex> lock(tablesMutex);
+	auto it = tables.find(&structure);
+	if (it != tables.end())
+		return it->second;
+
+	MemberIndexTable table;
+	table.fill(MISSING_MEMBER);
+	unsigned int memberIndex = 0;
+	for (auto memberIt = structure.begin(); memberIt != structure.end(); ++memberIt, ++memberIndex) {
+		const char* memberName = memberIt->name();
+		for (size_t m = 0; m < MATERIAL_MEMBER_COUNT; m++) {
+			if (std::strcmp(memberName, MATERIAL_MEMBER_NAMES[m]) == 0) {
+				table[m] = memberIndex;
+				break;
+			}
 		}
 	}
-	array.fill(0.0);
+	return tables.emplace(&structure, table).first->second;
 }
 
-std::string getTexture(adsk::Data::Handle& sHandle, const std::string& texName) {
-	std::string r;
-	if (sHandle.setPositionByMemberName(texName.c_str()))
-		r = (char*)sHandle.asUInt8();
-	return r;
-}
+} // namespace
 
-double getDouble(adsk::Data::Handle& sHandle, const std::string& name) {
-	if (sHandle.setPositionByMemberName(name.c_str())) {
-		double* data = sHandle.asDouble();
-		if (sHandle.dataLength() >= 1 && data != nullptr) {
-			return *data;
+// reads the material members by index and hashes their raw bytes in the same pass
+class MaterialInfo::Reader {
+public:
+	Reader(adsk::Data::Handle& handle, const adsk::Data::Structure& structure)
+	    : mHandle(handle), mMemberIndices(getMemberIndexTable(structure)) {}
+
+	std::string getTexture(MaterialMember member) {
+		std::string texture;
+		if (setPosition(member)) {
+			const char* data = reinterpret_cast<const char*>(mHandle.asUInt8());
+			if (data != nullptr)
+				texture.assign(data, strnlen(data, mHandle.dataLength()));
 		}
+		mHash.add(texture.size());
+		mHash.add(texture.data(), texture.size());
+		return texture;
 	}
-	return NAN;
-}
 
-} // namespace
+	double getDouble(MaterialMember member) {
+		double value = NAN;
+		if (setPosition(member)) {
+			const double* data = mHandle.asDouble();
+			if (mHandle.dataLength() >= 1 && data != nullptr)
+				value = *data;
+		}
+		mHash.add(value);
+		return value;
+	}
 
-MaterialColor::MaterialColor(adsk::Data::Handle& sHandle, const std::string& name) {
-	getDoubleArray(data, sHandle, name);
-}
+	template <size_t N>
+	std::array<double, N> getDoubleArray(MaterialMember member) {
+		std::array<double, N> array;
+		array.fill(0.0);
+		if (setPosition(member)) {
+			const double* data = mHandle.asDouble();
+			if (mHandle.dataLength() >= N && data != nullptr)
+				std::copy(data, data + N, array.begin());
+		}
+		mHash.add(array);
+		return array;
+	}
+
+	uint64_t getHash() const {
+		return mHash.value();
+	}
+
+private:
+	bool setPosition(MaterialMember member) {
+		const unsigned int memberIndex = mMemberIndices[member];
+		return (memberIndex != MISSING_MEMBER) && mHandle.setPositionByMemberIndex(memberIndex);
+	}
+
+	adsk::Data::Handle& mHandle;
+	const MemberIndexTable& mMemberIndices;
+	prtu::Fnv1aHash mHash;
+};
+
+MaterialColor::MaterialColor(const std::array<double, 3>& values) : data(values) {}
 
 double MaterialColor::r() const noexcept {
 	return data[0];
@@ -72,13 +170,6 @@ double MaterialColor::b() const noexcept {
 	return data[2];
 }
 
-size_t MaterialColor::getHash() const {
-	size_t seed = 0;
-	for (double elem : data)
-		prtu::hash_combine(seed, std::hash<double>{}(elem));
-	return seed;
-}
-
 bool MaterialColor::operator==(const MaterialColor& other) const noexcept {
 	return this->data == other.data;
 }
@@ -91,9 +182,7 @@ bool MaterialColor::operator>(const MaterialColor& rhs) const noexcept {
 	return rhs < *this;
 }
 
-MaterialTrafo::MaterialTrafo(adsk::Data::Handle& sHandle, const std::string& name) {
-	getDoubleArray(data, sHandle, name);
-}
+MaterialTrafo::MaterialTrafo(const std::array<double, 5>& values) : data(values) {}
 
 double MaterialTrafo::su() const noexcept {
 	return data[0];
@@ -115,13 +204,6 @@ double MaterialTrafo::rw() const noexcept {
 	return data[4];
 }
 
-size_t MaterialTrafo::getHash() const {
-	size_t seed = 0;
-	for (double elem : data)
-		prtu::hash_combine(seed, std::hash<double>{}(elem));
-	return seed;
-}
-
 std::array<double, 2> MaterialTrafo::tuv() const noexcept {
 	return {tu(), tv()};
 }
@@ -142,23 +224,33 @@ bool MaterialTrafo::operator>(const MaterialTrafo& rhs) const noexcept {
 	return rhs < *this;
 }
 
-MaterialInfo::MaterialInfo(adsk::Data::Handle& handle)
-    : bumpMap(getTexture(handle, "bumpMap")), colormap(getTexture(handle, "diffuseMap")),
-      dirtmap(getTexture(handle, "diffuseMap1")), emissiveMap(getTexture(handle, "emissiveMap")),
-      metallicMap(getTexture(handle, "metallicMap")), normalMap(getTexture(handle, "normalMap")),
-      occlusionMap(getTexture(handle, "occlusionMap")), opacityMap(getTexture(handle, "opacityMap")),
-      roughnessMap(getTexture(handle, "roughnessMap")), specularMap(getTexture(handle, "specularMap")),
+MaterialInfo::MaterialInfo(adsk::Data::Handle& handle, const adsk::Data::Structure& structure)
+    : MaterialInfo(Reader(handle, structure)) {}
+
+MaterialInfo::MaterialInfo(Reader&& reader)
+    : bumpMap(reader.getTexture(BUMP_MAP)), colormap(reader.getTexture(COLOR_MAP)),
+      dirtmap(reader.getTexture(DIRT_MAP)), emissiveMap(reader.getTexture(EMISSIVE_MAP)),
+      metallicMap(reader.getTexture(METALLIC_MAP)), normalMap(reader.getTexture(NORMAL_MAP)),
+      occlusionMap(reader.getTexture(OCCLUSION_MAP)), opacityMap(reader.getTexture(OPACITY_MAP)),
+      roughnessMap(reader.getTexture(ROUGHNESS_MAP)), specularMap(reader.getTexture(SPECULAR_MAP)),
+
+      opacity(reader.getDouble(OPACITY)), metallic(reader.getDouble(METALLIC)),
+      roughness(reader.getDouble(ROUGHNESS)),
+
+      ambientColor(reader.getDoubleArray<3>(AMBIENT_COLOR)), diffuseColor(reader.getDoubleArray<3>(DIFFUSE_COLOR)),
+      emissiveColor(reader.getDoubleArray<3>(EMISSIVE_COLOR)), specularColor(reader.getDoubleArray<3>(SPECULAR_COLOR)),
 
-      opacity(getDouble(handle, "opacity")), metallic(getDouble(handle, "metallic")),
-      roughness(getDouble(handle, "roughness")),
+      specularmapTrafo(reader.getDoubleArray<5>(SPECULARMAP_TRAFO)),
+      bumpmapTrafo(reader.getDoubleArray<5>(BUMPMAP_TRAFO)), colormapTrafo(reader.getDoubleArray<5>(COLORMAP_TRAFO)),
+      dirtmapTrafo(reader.getDoubleArray<5>(DIRTMAP_TRAFO)),
+      emissivemapTrafo(reader.getDoubleArray<5>(EMISSIVEMAP_TRAFO)),
+      metallicmapTrafo(reader.getDoubleArray<5>(METALLICMAP_TRAFO)),
+      normalmapTrafo(reader.getDoubleArray<5>(NORMALMAP_TRAFO)),
+      occlusionmapTrafo(reader.getDoubleArray<5>(OCCLUSIONMAP_TRAFO)),
+      opacitymapTrafo(reader.getDoubleArray<5>(OPACITYMAP_TRAFO)),
+      roughnessmapTrafo(reader.getDoubleArray<5>(ROUGHNESSMAP_TRAFO)),
 
-      ambientColor(handle, "ambientColor"), bumpmapTrafo(handle, "bumpmapTrafo"),
-      colormapTrafo(handle, "colormapTrafo"), diffuseColor(handle, "diffuseColor"),
-      dirtmapTrafo(handle, "dirtmapTrafo"), emissiveColor(handle, "emissiveColor"),
-      emissivemapTrafo(handle, "emissivemapTrafo"), metallicmapTrafo(handle, "metallicmapTrafo"),
-      normalmapTrafo(handle, "normalmapTrafo"), occlusionmapTrafo(handle, "occlusionmapTrafo"),
-      opacitymapTrafo(handle, "opacitymapTrafo"), roughnessmapTrafo(handle, "roughnessmapTrafo"),
-      specularColor(handle, "specularColor"), specularmapTrafo(handle, "specularmapTrafo") {}
+      mHash(reader.getHash()) {}
 
 bool MaterialInfo::equals(const MaterialInfo& o) const {
 	// clang-format off
@@ -262,37 +354,5 @@ bool MaterialInfo::operator<(const MaterialInfo& rhs) const {
 }
 
 size_t MaterialInfo::getHash() const {
-	std::size_t seed = 0;
-
-	prtu::hash_combine(seed, std::hash<std::string>{}(bumpMap));
-	prtu::hash_combine(seed, std::hash<std::string>{}(colormap));
-	prtu::hash_combine(seed, std::hash<std::string>{}(dirtmap));
-	prtu::hash_combine(seed, std::hash<std::string>{}(emissiveMap));
-	prtu::hash_combine(seed, std::hash<std::string>{}(metallicMap));
-	prtu::hash_combine(seed, std::hash<std::string>{}(normalMap));
-	prtu::hash_combine(seed, std::hash<std::string>{}(occlusionMap));
-	prtu::hash_combine(seed, std::hash<std::string>{}(opacityMap));
-	prtu::hash_combine(seed, std::hash<std::string>{}(roughnessMap));
-	prtu::hash_combine(seed, std::hash<std::string>{}(specularMap));
-
-	prtu::hash_combine(seed, std::hash<double>{}(opacity));
-	prtu::hash_combine(seed, std::hash<double>{}(metallic));
-	prtu::hash_combine(seed, std::hash<double>{}(roughness));
-
-	prtu::hash_combine(seed, ambientColor.getHash());
-	prtu::hash_combine(seed, diffuseColor.getHash());
-	prtu::hash_combine(seed, emissiveColor.getHash());
-	prtu::hash_combine(seed, specularColor.getHash());
-	prtu::hash_combine(seed, specularmapTrafo.getHash());
-	prtu::hash_combine(seed, bumpmapTrafo.getHash());
-	prtu::hash_combine(seed, dirtmapTrafo.getHash());
-	prtu::hash_combine(seed, emissivemapTrafo.getHash());
-	prtu::hash_combine(seed, metallicmapTrafo.getHash());
-	prtu::hash_combine(seed, normalmapTrafo.getHash());
-	prtu::hash_combine(seed, occlusionmapTrafo.getHash());
-	prtu::hash_combine(seed, opacitymapTrafo.getHash());
-	prtu::hash_combine(seed, roughnessmapTrafo.getHash());
-	prtu::hash_combine(seed, specularmapTrafo.getHash());
-
-	return seed;
+	return static_cast<size_t>(mHash);
 }
@@ -23,8 +23,10 @@
 
 #include "maya/MString.h"
 #include "maya/adskDataHandle.h"
+#include "maya/adskDataStructure.h"
 
 #include <array>
+#include <cstdint>
 
 const std::string PRT_MATERIAL_STRUCTURE = "prtMaterialStructure";
 const std::string PRT_MATERIAL_CHANNEL = "prtMaterialChannel";
@@ -42,14 +44,12 @@ const MELVariable MEL_VARIABLE_SHADING_ENGINE(L"shadingGroup");
 
 class MaterialColor {
 public:
-	MaterialColor(adsk::Data::Handle& sHandle, const std::string& name);
+	explicit MaterialColor(const std::array<double, 3>& values);
 
 	double r() const noexcept;
 	double g() const noexcept;
 	double b() const noexcept;
 
-	size_t getHash() const;
-
 	bool operator==(const MaterialColor& other) const noexcept;
 	bool operator<(const MaterialColor& rhs) const noexcept;
 	bool operator>(const MaterialColor& rhs) const noexcept;
@@ -60,7 +60,7 @@ private:
 
 class MaterialTrafo {
 public:
-	MaterialTrafo(adsk::Data::Handle& sHandle, const std::string& name);
+	explicit MaterialTrafo(const std::array<double, 5>& values);
 
 	double su() const noexcept;
 	double sv() const noexcept;
@@ -68,8 +68,6 @@ public:
 	double tv() const noexcept;
 	double rw() const noexcept;
 
-	size_t getHash() const;
-
 	std::array<double, 2> tuv() const noexcept;
 	std::array<double, 3> suvw() const noexcept;
 
@@ -83,7 +81,7 @@ private:
 
 class MaterialInfo {
 public:
-	explicit MaterialInfo(adsk::Data::Handle& handle);
+	MaterialInfo(adsk::Data::Handle& handle, const adsk::Data::Structure& structure);
 
 	std::string bumpMap;
 	std::string colormap;
@@ -121,4 +119,11 @@ public:
 	bool operator<(const MaterialInfo& rhs) const;
 
 	size_t getHash() const;
+
+private:
+	class Reader;
+	explicit MaterialInfo(Reader&& reader);
+
+	// accumulated by the reader while the members above are initialized, must be declared last
+	uint64_t mHash;
 };
@@ -21,11 +21,19 @@
 #include "materials/MaterialUtils.h"
 
 #include "utils/MELScriptBuilder.h"
+#include "utils/MayaUtilities.h"
+#include "utils/Utilities.h"
 
+#include "maya/MDagPath.h"
+#include "maya/MFnSet.h"
+#include "maya/MFnSingleIndexedComponent.h"
 #include "maya/MFnTypedAttribute.h"
+#include "maya/MSelectionList.h"
 #include "maya/MUuid.h"
 
+#include <map>
 #include <mutex>
+#include <vector>
 
 namespace {
 std::once_flag pluginDependencyCheckFlag;
@@ -57,6 +65,36 @@ MStatus MaterialNode::initializeAttributes(MObject& inMesh, MObject& outMesh) {
 	return MStatus::kSuccess;
 }
 
+MaterialNode::AssignmentStatus MaterialNode::getAssignmentStatus(const MString& meshName) const {
+	if (mAssignedFaceRanges.empty())
+		return AssignmentStatus::INTACT;
+
+	MSelectionList selection;
+	MDagPath meshPath;
+	if ((selection.add(meshName) != MStatus::kSuccess) || (selection.getDagPath(0, meshPath) != MStatus::kSuccess))
+		return AssignmentStatus::MISSING;
+
+	for (const auto& [shadingEngineUuid, faceRange] : mAssignedFaceRanges) {
+		MStatus status;
+		const MObject shadingEngineObj = mu::getNodeObjFromUuid(shadingEngineUuid, status);
+		if (status != MStatus::kSuccess)
+			return AssignmentStatus::MISSING; // deleted, e.g. by "delete unused nodes" or undo
+
+		MFnSet shadingEngine(shadingEngineObj, &status);
+		if (status != MStatus::kSuccess)
+			return AssignmentStatus::MISSING;
+
+		// not (yet) a member if the assignment script did not run or the face was reassigned by hand
+		MFnSingleIndexedComponent faceComponent;
+		MObject face = faceComponent.create(MFn::kMeshPolygonComponent, &status);
+		MCHECK(status);
+		MCHECK(faceComponent.addElement(faceRange.first));
+		if (!shadingEngine.isMember(meshPath, face))
+			return AssignmentStatus::NOT_MEMBER;
+	}
+	return AssignmentStatus::INTACT;
+}
+
 MStatus MaterialNode::compute(const MPlug& plug, MDataBlock& data) {
 	MObject inMesh = getInMesh();
 	MObject outMesh = getOutMesh();
@@ -82,16 +120,60 @@ MStatus MaterialNode::compute(const MPlug& plug, MDataBlock& data) {
 		return meshNameStatus;
 
 	adsk::Data::Stream* inMatStream = MaterialUtils::getMaterialStream(inMesh, data);
+
+	const adsk::Data::Structure* materialStructure = nullptr;
+	if (inMatStream != nullptr) {
+		materialStructure = adsk::Data::Structure::structureByName(PRT_MATERIAL_STRUCTURE.c_str());
+		if (materialStructure == nullptr)
+			return MStatus::kFailure;
+	}
+
+	// read the material stream and compute its digest, if it did not change since the last compute (e.g. only the
+	// vertex positions changed) the shading engines and assignments are still valid
+	prtu::Fnv1aHash digest;
+	digest.add(meshName.asWChar(), meshName.length() * sizeof(wchar_t));
+	digest.add(inMatStream != nullptr);
+
+	std::vector<std::pair<std::pair<int, int>, MaterialInfo>> faceRangeMaterials;
+	if (inMatStream != nullptr) {
+		for (adsk::Data::Handle& inMatStreamHandle : *inMatStream) {
+			if (!inMatStreamHandle.hasData())
+				continue;
+
+			if (!inMatStreamHandle.usesStructure(*materialStructure))
+				continue;
+
+			std::pair<int, int> faceRange;
+			if (!MaterialUtils::getFaceRange(inMatStreamHandle, faceRange) || faceRange.first >= faceRange.second)
+				continue;
+
+			faceRangeMaterials.emplace_back(faceRange, MaterialInfo(inMatStreamHandle, *materialStructure));
+			digest.add(faceRange.first);
+			digest.add(faceRange.second);
+			digest.add(faceRangeMaterials.back().second.getHash());
+		}
+	}
+
+	if (mMaterialStreamDigest == digest.value()) {
+		const AssignmentStatus assignmentStatus = getAssignmentStatus(meshName);
+		if (assignmentStatus == AssignmentStatus::INTACT) {
+			mAssignmentPending = false;
+			return MStatus::kSuccess;
+		}
+		// the queued assignment script did not run yet, queueing it again would only repeat the same work
+		if (mAssignmentPending && (assignmentStatus == AssignmentStatus::NOT_MEMBER))
+			return MStatus::kSuccess;
+	}
+	mMaterialStreamDigest.reset();
+	mAssignmentPending = false;
+	mAssignedFaceRanges.clear();
+
 	if (inMatStream == nullptr) {
 		MaterialUtils::resetMaterial(meshName.asWChar());
+		mMaterialStreamDigest = digest.value();
 		return MStatus::kSuccess;
 	}
 
-	const adsk::Data::Structure* materialStructure =
-	        adsk::Data::Structure::structureByName(PRT_MATERIAL_STRUCTURE.c_str());
-	if (materialStructure == nullptr)
-		return MStatus::kFailure;
-
 	MaterialUtils::MaterialCache matCache = MaterialUtils::getMaterialCache();
 
 	MELScriptBuilder scriptBuilder;
@@ -101,36 +183,31 @@ MStatus MaterialNode::compute(const MPlug& plug, MDataBlock& data) {
 
 	declareMaterialStrings(scriptBuilder);
 
-	for (adsk::Data::Handle& inMatStreamHandle : *inMatStream) {
-		if (!inMatStreamHandle.hasData())
-			continue;
+	// collect the face ranges per shading engine to emit a single sets command per shading engine
+	std::map<std::wstring, std::vector<std::pair<int, int>>> shadingEngineFaceRanges;
+	std::map<std::wstring, MUuid> shadingEngineUuids;
 
-		if (!inMatStreamHandle.usesStructure(*materialStructure))
-			continue;
+	auto createShadingEngine = [this, baseName, &scriptBuilder](const MaterialInfo& matInfo) {
+		const std::wstring shadingEngineBaseName = baseName + L"Sg";
+		const std::wstring shaderBaseName = baseName + L"Sh";
 
-		std::pair<int, int> faceRange;
-		if (!MaterialUtils::getFaceRange(inMatStreamHandle, faceRange))
-			continue;
+		MStatus status;
+		const std::wstring shadingEngineName = MaterialUtils::synchronouslyCreateShadingEngine(
+		        shadingEngineBaseName, MEL_VARIABLE_SHADING_ENGINE, status);
+		MCHECK(status);
 
-		auto createShadingEngine = [this, baseName, &materialStructure, &scriptBuilder,
-		                            &inMatStreamHandle](const MaterialInfo& matInfo) {
-			const std::wstring shadingEngineBaseName = baseName + L"Sg";
-			const std::wstring shaderBaseName = baseName + L"Sh";
+		MUuid shadingEngineNameUuid = mu::getNodeUuid(MString(shadingEngineName.c_str()));
+		MCHECK(MaterialUtils::addMaterialInfoMapMetadata(matInfo.getHash(), shadingEngineNameUuid));
+		appendToMaterialScriptBuilder(scriptBuilder, matInfo, shaderBaseName, shadingEngineName);
+		LOG_DBG << "new shading engine: " << shadingEngineName;
 
-			MStatus status;
-			const std::wstring shadingEngineName = MaterialUtils::synchronouslyCreateShadingEngine(
-			        shadingEngineBaseName, MEL_VARIABLE_SHADING_ENGINE, status);
-			MCHECK(status);
+		return shadingEngineNameUuid;
+	};
 
-			MUuid shadingEngineNameUuid = mu::getNodeUuid(MString(shadingEngineName.c_str()));
-			MCHECK(MaterialUtils::addMaterialInfoMapMetadata(matInfo.getHash(), shadingEngineNameUuid));
-			appendToMaterialScriptBuilder(scriptBuilder, matInfo, shaderBaseName, shadingEngineName);
-			LOG_DBG << "new shading engine: " << shadingEngineName;
+	for (const auto& faceRangeMaterial : faceRangeMaterials) {
+		const std::pair<int, int>& faceRange = faceRangeMaterial.first;
+		const MaterialInfo& matInfo = faceRangeMaterial.second;
 
-			return shadingEngineNameUuid;
-		};
-
-		MaterialInfo matInfo(inMatStreamHandle);
 		const MUuid shadingEngineUuid = getCachedValue(matCache, matInfo.getHash(), createShadingEngine, matInfo);
 
 		MObject shadingEngineNodeObj = mu::getNodeObjFromUuid(shadingEngineUuid, status);
@@ -142,11 +219,26 @@ MStatus MaterialNode::compute(const MPlug& plug, MDataBlock& data) {
 
 		MFnDependencyNode shadingEngineNode(shadingEngineNodeObj);
 		const std::wstring shadingEngineName = shadingEngineNode.name().asWChar();
+		shadingEngineUuids.emplace(shadingEngineName, shadingEngineNode.uuid());
 
-		scriptBuilder.setsAddFaceRange(shadingEngineName, meshName.asWChar(), faceRange.first, faceRange.second);
+		prtu::appendFaceRange(shadingEngineFaceRanges[shadingEngineName], faceRange);
 		LOG_DBG << "assigned shading engine (" << faceRange.first << ":" << faceRange.second
 		        << "): " << shadingEngineName;
 	}
+
+	for (const auto& shadingEngineFaceRange : shadingEngineFaceRanges)
+		scriptBuilder.setsAddFaceRanges(shadingEngineFaceRange.first, meshName.asWChar(),
+		                                shadingEngineFaceRange.second);
+
 	scriptBuilder.setUndoState(MEL_UNDO_STATE);
-	return scriptBuilder.execute();
+	status = scriptBuilder.execute();
+	if (status == MStatus::kSuccess) {
+		// the script is only queued, getAssignmentStatus() confirms it ran once the faces are members
+		mMaterialStreamDigest = digest.value();
+		mAssignmentPending = !shadingEngineFaceRanges.empty();
+		for (const auto& shadingEngineFaceRange : shadingEngineFaceRanges)
+			mAssignedFaceRanges.emplace_back(shadingEngineUuids.at(shadingEngineFaceRange.first),
+			                                 shadingEngineFaceRange.second.front());
+	}
+	return status;
 }
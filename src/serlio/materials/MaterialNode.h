@@ -20,7 +20,12 @@
 #pragma once
 
 #include "maya/MPxNode.h"
+#include "maya/MString.h"
+#include "maya/MUuid.h"
 
+#include <cstdint>
+#include <optional>
+#include <utility>
 #include <vector>
 
 class MaterialInfo;
@@ -47,4 +52,17 @@ private:
 	virtual MObject getInMesh() const = 0;
 	virtual MObject getOutMesh() const = 0;
 	virtual std::vector<std::string> getPluginDependencies() const = 0;
+
+	enum class AssignmentStatus { INTACT, NOT_MEMBER, MISSING };
+
+	// INTACT if the shading engines of the last assignment still exist and still hold their first face
+	AssignmentStatus getAssignmentStatus(const MString& meshName) const;
+
+	// digest of the mesh name and the material stream of the last requested assignment
+	std::optional<uint64_t> mMaterialStreamDigest;
+	// true while the assignment script of mMaterialStreamDigest is queued and was not yet seen intact
+	bool mAssignmentPending = false;
+	// the shading engines of the last requested assignment together with one of their face ranges. the assignment
+	// script only runs on idle, so these are checked before an unchanged material stream is skipped
+	std::vector<std::pair<MUuid, std::pair<int, int>>> mAssignedFaceRanges;
 };
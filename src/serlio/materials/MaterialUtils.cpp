@@ -37,8 +37,6 @@
 namespace {
 const MELVariable MEL_UNDO_STATE(L"materialUndoState");
 
-constexpr const wchar_t* RGBA8_FORMAT = L"RGBA8";
-constexpr const wchar_t* FORMAT_STRING = L"format";
 constexpr const size_t UUID_UINT8_LENGTH = 16;
 
 adsk::Data::Structure* createNewMaterialInfoMapStructure() {
@@ -277,13 +275,7 @@ std::filesystem::path getStingrayShaderPath() {
 }
 
 bool textureHasAlphaChannel(const std::wstring& path) {
-	const AttributeMapUPtr textureMetadata(prt::createTextureMetadata(prtu::toFileURI(path).c_str()));
-	if (textureMetadata == nullptr)
-		return false;
-	const wchar_t* format = textureMetadata->getString(FORMAT_STRING);
-	if (format != nullptr && std::wcscmp(format, RGBA8_FORMAT) == 0)
-		return true;
-	return false;
+	return PRTContext::get().mAssetCache.getTextureMetadataCache().hasAlphaChannel(path);
 }
 
 void resetMaterial(const std::wstring& meshName) {
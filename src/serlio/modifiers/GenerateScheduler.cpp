@@ -0,0 +1,150 @@
+/**
+ * Serlio - Esri CityEngine Plugin for Autodesk Maya
+ *
+ * See https://github.com/esri/serlio for build and usage instructions.
+ *
+ * Copyright (c) 2012-2022 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "modifiers/GenerateScheduler.h"
+#include "modifiers/PRTModifierAction.h"
+#include "modifiers/PRTModifierNode.h"
+
+#include "utils/LogHandler.h"
+#include "utils/MayaUtilities.h"
+
+#include "maya/MGlobal.h"
+#include "maya/MUuid.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+constexpr bool DBG = false;
+
+// async jobs start once no further jobs were queued for this long, e.g. while an attribute is scrubbed
+constexpr std::chrono::milliseconds ASYNC_GENERATE_DEBOUNCE(50);
+
+// but at the latest this long after the first job was queued, so continuous scrubbing still shows intermediate results
+constexpr std::chrono::milliseconds MAX_ASYNC_GENERATE_DELAY = 8 * ASYNC_GENERATE_DEBOUNCE;
+
+} // namespace
+
+GenerateScheduler& GenerateScheduler::get() {
+	static GenerateScheduler scheduler;
+	return scheduler;
+}
+
+GenerateScheduler::~GenerateScheduler() {
+	shutdown();
+}
+
+void GenerateScheduler::shutdown() {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopAsyncThread = true;
+		for (const std::shared_ptr<AsyncGenerateJob>& job : mRunningAsyncJobs)
+			job->superseded = true;
+	}
+	mAsyncCondition.notify_all();
+	if (mAsyncThread.joinable())
+		mAsyncThread.join();
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mAsyncJobs.clear();
+	mFinishedNodeUuids.clear();
+	mStopAsyncThread = false;
+}
+
+void GenerateScheduler::generateAsync(std::shared_ptr<AsyncGenerateJob> job) {
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mAsyncJobs.push_back(std::move(job));
+		if (!mAsyncThread.joinable())
+			mAsyncThread = std::thread(&GenerateScheduler::runAsyncJobs, this);
+	}
+	mAsyncCondition.notify_all();
+}
+
+void GenerateScheduler::runAsyncJobs() {
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (true) {
+		mAsyncCondition.wait(lock, [this]() { return mStopAsyncThread || !mAsyncJobs.empty(); });
+		if (mStopAsyncThread)
+			return;
+
+		const auto latestStart = std::chrono::steady_clock::now() + MAX_ASYNC_GENERATE_DELAY;
+		size_t queuedJobs = mAsyncJobs.size();
+		while (std::chrono::steady_clock::now() < latestStart) {
+			const auto debounceEnd = std::min(std::chrono::steady_clock::now() + ASYNC_GENERATE_DEBOUNCE, latestStart);
+			const bool hasNewJobs = mAsyncCondition.wait_until(lock, debounceEnd, [this, &queuedJobs]() {
+				return mStopAsyncThread || mAsyncJobs.size() != queuedJobs;
+			});
+			if (mStopAsyncThread)
+				return;
+			if (!hasNewJobs)
+				break;
+			queuedJobs = mAsyncJobs.size();
+		}
+
+		std::vector<std::shared_ptr<AsyncGenerateJob>> jobs;
+		jobs.swap(mAsyncJobs);
+		jobs.erase(std::remove_if(jobs.begin(), jobs.end(),
+		                          [](const std::shared_ptr<AsyncGenerateJob>& job) { return job->superseded.load(); }),
+		           jobs.end());
+		mRunningAsyncJobs = jobs;
+		lock.unlock();
+
+		std::vector<GenerateJob*> batch;
+		batch.reserve(jobs.size());
+		for (const std::shared_ptr<AsyncGenerateJob>& job : jobs)
+			batch.push_back(job.get());
+
+		if (DBG)
+			LOG_DBG << "generating async batch of " << batch.size() << " initial shapes";
+
+		// failures are recorded in the jobs and reported by the nodes, this thread must not report to Maya
+		PRTModifierAction::generate(batch);
+
+		lock.lock();
+		mRunningAsyncJobs.clear();
+
+		// the nodes pick up the result on their next compute, which must be triggered from the main thread
+		const bool isUpdateQueued = !mFinishedNodeUuids.empty(); // the queued task also takes the new nodes
+		for (const std::shared_ptr<AsyncGenerateJob>& job : jobs) {
+			job->done = true;
+			if (!job->superseded)
+				mFinishedNodeUuids.push_back(job->nodeUuid);
+		}
+		if (!isUpdateQueued && !mFinishedNodeUuids.empty())
+			MGlobal::executeTaskOnIdle(&GenerateScheduler::updateFinishedNodes);
+	}
+}
+
+void GenerateScheduler::updateFinishedNodes(void* /*data*/) {
+	GenerateScheduler& scheduler = GenerateScheduler::get();
+	std::vector<std::wstring> nodeUuids;
+	{
+		std::lock_guard<std::mutex> lock(scheduler.mMutex);
+		nodeUuids.swap(scheduler.mFinishedNodeUuids);
+	}
+
+	for (const std::wstring& nodeUuid : nodeUuids) {
+		MStatus status;
+		const MObject node = mu::getNodeObjFromUuid(MUuid(MString(nodeUuid.c_str())), status);
+		if (status == MStatus::kSuccess) // the node might have been deleted in the meantime
+			PRTModifierNode::triggerUpdate(node);
+	}
+}
@@ -0,0 +1,66 @@
+/**
+ * Serlio - Esri CityEngine Plugin for Autodesk Maya
+ *
+ * See https://github.com/esri/serlio for build and usage instructions.
+ *
+ * Copyright (c) 2012-2022 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct AsyncGenerateJob;
+
+// Generates the jobs of serlio nodes in asynchronous mode on a background thread. The jobs queued while a batch is
+// generated are generated together with a single prt::generate call.
+class GenerateScheduler {
+public:
+	static GenerateScheduler& get();
+
+	GenerateScheduler() = default;
+	~GenerateScheduler();
+	GenerateScheduler(const GenerateScheduler&) = delete;
+	GenerateScheduler(GenerateScheduler&&) = delete;
+	GenerateScheduler& operator=(GenerateScheduler const&) = delete;
+	GenerateScheduler& operator=(GenerateScheduler&&) = delete;
+
+	// queues the job for the background thread, which generates all queued jobs in one batch and dirties the output
+	// of their nodes when done. the batch starts after a short debounce period, superseded jobs are dropped or
+	// canceled while generating
+	void generateAsync(std::shared_ptr<AsyncGenerateJob> job);
+
+	// cancels the running batch, drops the queued jobs and joins the background thread, e.g. when the plugin is
+	// unloaded. a later generateAsync() starts a new thread
+	void shutdown();
+
+private:
+	void runAsyncJobs();
+
+	// idle task on the main thread, dirties the nodes whose jobs are done
+	static void updateFinishedNodes(void* data);
+
+	std::mutex mMutex;
+	std::vector<std::shared_ptr<AsyncGenerateJob>> mAsyncJobs;        // queued for the background thread
+	std::vector<std::shared_ptr<AsyncGenerateJob>> mRunningAsyncJobs; // generated by the background thread
+	std::vector<std::wstring> mFinishedNodeUuids;                    // waiting for updateFinishedNodes()
+	std::condition_variable mAsyncCondition;
+	std::thread mAsyncThread; // started with the first async job
+	bool mStopAsyncThread = false;
+};
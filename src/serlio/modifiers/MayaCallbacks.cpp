@@ -19,6 +19,7 @@
 
 #include "modifiers/MayaCallbacks.h"
 #include "modifiers/PRTModifierNode.h"
+#include "modifiers/ReportInfo.h"
 
 #include "materials/MaterialInfo.h"
 
@@ -35,12 +36,15 @@
 #include "maya/MFloatVectorArray.h"
 #include "maya/MFnDependencyNode.h"
 #include "maya/MFnMesh.h"
-#include "maya/MFnMeshData.h"
 #include "maya/adskDataAssociations.h"
 #include "maya/adskDataStream.h"
 
+#include <algorithm>
 #include <cassert>
+#include <map>
+#include <memory>
 #include <sstream>
+#include <unordered_map>
 
 namespace {
 
@@ -48,6 +52,11 @@ constexpr bool DBG = false;
 constexpr const wchar_t* MAYA_ASSET_FOLDER = L"assets";
 constexpr const wchar_t* SERLIO_ASSET_FOLDER = L"serlio_assets";
 
+std::mutex structureRegistryMutex;
+
+// PRT stops generating an initial shape as soon as one of its callbacks does not return STATUS_OK
+constexpr prt::Status STATUS_CANCELED = prt::STATUS_UNSPECIFIED_ERROR;
+
 void checkStringLength(const wchar_t* string, const size_t& maxStringLength) {
 	if (wcslen(string) >= maxStringLength) {
 		const std::wstring msg = L"Maximum texture path size is " + std::to_wstring(maxStringLength);
@@ -108,17 +117,48 @@ void assignTextureCoordinates(MFnMesh& fnMesh, double const* const* uvs, size_t
 
 	fnMesh.clearUVs();
 
+	// the encoder lets uv sets with identical data share their arrays, convert each distinct set only once
+	struct MayaUVSet {
+		const double* uvs;
+		const uint32_t* uvCounts;
+		const uint32_t* uvIndices;
+		MFloatArray mU;
+		MFloatArray mV;
+		MIntArray mUVCounts;
+		MIntArray mUVIndices;
+	};
+	std::vector<MayaUVSet> mayaUVSets;
+	mayaUVSets.reserve(uvSetsCount);
+
+	const auto getMayaUVSet = [&](uint8_t uvSet) -> const MayaUVSet& {
+		const auto it = std::find_if(mayaUVSets.begin(), mayaUVSets.end(), [&](const MayaUVSet& s) {
+			return (s.uvs == uvs[uvSet]) && (s.uvCounts == uvCounts[uvSet]) && (s.uvIndices == uvIndices[uvSet]);
+		});
+		if (it != mayaUVSets.end())
+			return *it;
+
+		const unsigned int uvCount = static_cast<unsigned int>(uvsSizes[uvSet] / 2);
+		MayaUVSet& mayaUVSet = mayaUVSets.emplace_back();
+		mayaUVSet.uvs = uvs[uvSet];
+		mayaUVSet.uvCounts = uvCounts[uvSet];
+		mayaUVSet.uvIndices = uvIndices[uvSet];
+		mayaUVSet.mU.setLength(uvCount);
+		mayaUVSet.mV.setLength(uvCount);
+		mayaUVSet.mUVCounts = toMayaIntArray(uvCounts[uvSet], uvCountsSizes[uvSet]);
+		mayaUVSet.mUVIndices = toMayaIntArray(uvIndices[uvSet], uvIndicesSizes[uvSet]);
+		for (unsigned int uvIdx = 0; uvIdx < uvCount; ++uvIdx) {
+			mayaUVSet.mU[uvIdx] = static_cast<float>(uvs[uvSet][uvIdx * 2 + 0]); // maya mesh only supports float uvs
+			mayaUVSet.mV[uvIdx] = static_cast<float>(uvs[uvSet][uvIdx * 2 + 1]);
+		}
+		return mayaUVSet;
+	};
+
 	for (const TextureUVOrder& o : TEXTURE_UV_ORDERS) {
 		const uint8_t uvSet = o.prtUvSetIndex;
 		const MString uvSetName = o.mayaUvSetName;
 
 		if (uvSetsCount > uvSet && uvsSizes[uvSet] > 0) {
-			MFloatArray mU;
-			MFloatArray mV;
-			for (size_t uvIdx = 0; uvIdx < uvsSizes[uvSet] / 2; ++uvIdx) {
-				mU.append(static_cast<float>(uvs[uvSet][uvIdx * 2 + 0])); // maya mesh only supports float uvs
-				mV.append(static_cast<float>(uvs[uvSet][uvIdx * 2 + 1]));
-			}
+			const MayaUVSet& mayaUVSet = getMayaUVSet(uvSet);
 
 			if (uvSet > 0) {
 				MStatus status;
@@ -126,11 +166,8 @@ void assignTextureCoordinates(MFnMesh& fnMesh, double const* const* uvs, size_t
 				MCHECK(status);
 			}
 
-			MCHECK(fnMesh.setUVs(mU, mV, &uvSetName));
-
-			MIntArray mUVCounts = toMayaIntArray(uvCounts[uvSet], uvCountsSizes[uvSet]);
-			MIntArray mUVIndices = toMayaIntArray(uvIndices[uvSet], uvIndicesSizes[uvSet]);
-			MCHECK(fnMesh.assignUVs(mUVCounts, mUVIndices, &uvSetName));
+			MCHECK(fnMesh.setUVs(mayaUVSet.mU, mayaUVSet.mV, &uvSetName));
+			MCHECK(fnMesh.assignUVs(mayaUVSet.mUVCounts, mayaUVSet.mUVIndices, &uvSetName));
 		}
 		else {
 			if (uvSet > 0) {
@@ -143,32 +180,61 @@ void assignTextureCoordinates(MFnMesh& fnMesh, double const* const* uvs, size_t
 	}
 }
 
+// true if all vertices of each face share the same normal, e.g. if the rule did not produce any vertex normals
+bool hasOnlyFaceNormals(const MIntArray& mayaFaceCounts, const double* nrm, const uint32_t* normalIndices) {
+	size_t indexCount = 0;
+	for (unsigned int i = 0; i < mayaFaceCounts.length(); i++) {
+		const size_t faceLength = static_cast<size_t>(mayaFaceCounts[i]);
+		const double* faceNormal = &nrm[size_t(normalIndices[indexCount]) * 3];
+
+		for (size_t j = 1; j < faceLength; j++) {
+			const double* normal = &nrm[size_t(normalIndices[indexCount + j]) * 3];
+			if ((normal != faceNormal) && !std::equal(faceNormal, faceNormal + 3, normal))
+				return false;
+		}
+		indexCount += faceLength;
+	}
+	return true;
+}
+
 void assignVertexNormals(MFnMesh& mFnMesh, const MIntArray& mayaFaceCounts, MIntArray& mayaVertexIndices,
                          const double* nrm, size_t nrmSize, const uint32_t* normalIndices,
-                         MAYBE_UNUSED size_t normalIndicesSize) {
+                         MAYBE_UNUSED size_t normalIndicesSize, bool normalsAsHardEdges) {
 	if (nrmSize == 0)
 		return;
 
 	assert(normalIndicesSize == mayaVertexIndices.length());
 	// guaranteed by MayaEncoder, see prtx::VertexNormalProcessor::SET_MISSING_TO_FACE_NORMALS
 
-	// convert to native maya normal layout
-	MVectorArray expandedNormals(static_cast<unsigned int>(mayaVertexIndices.length()));
-	MIntArray faceList(static_cast<unsigned int>(mayaVertexIndices.length()));
+	if (normalsAsHardEdges) {
+		// hard edges shade the same and let maya compute the (unlocked) face normals when needed
+		const int edgeCount = mFnMesh.numEdges();
+		MIntArray edgeIds(static_cast<unsigned int>(edgeCount));
+		for (int e = 0; e < edgeCount; e++)
+			edgeIds[e] = e;
+		const MIntArray smooths(static_cast<unsigned int>(edgeCount), 0);
 
-	int indexCount = 0;
-	for (uint32_t i = 0; i < mayaFaceCounts.length(); i++) {
-		int faceLength = mayaFaceCounts[i];
-
-		for (int j = 0; j < faceLength; j++) {
-			faceList[indexCount] = i;
-			int idx = normalIndices[indexCount];
-			expandedNormals.set(&nrm[idx * 3], indexCount);
-			indexCount++;
-		}
+		MCHECK(mFnMesh.setEdgeSmoothings(edgeIds, smooths));
+		MCHECK(mFnMesh.cleanupEdgeSmoothing());
+		return;
 	}
 
-	MCHECK(mFnMesh.setFaceVertexNormals(expandedNormals, faceList, mayaVertexIndices));
+	// convert to native maya normal layout, gathered into plain arrays which are copied into the maya arrays at once
+	const size_t faceVertexCount = mayaVertexIndices.length();
+	std::vector<double> expandedNormals(faceVertexCount * 3);
+	for (size_t i = 0; i < faceVertexCount; i++)
+		std::copy_n(&nrm[size_t(normalIndices[i]) * 3], 3, &expandedNormals[i * 3]);
+
+	std::vector<int> faceIndices(faceVertexCount);
+	auto faceIndexIt = faceIndices.begin();
+	for (unsigned int i = 0; i < mayaFaceCounts.length(); i++)
+		faceIndexIt = std::fill_n(faceIndexIt, mayaFaceCounts[i], static_cast<int>(i));
+
+	MVectorArray mayaNormals(reinterpret_cast<const double(*)[3]>(expandedNormals.data()),
+	                         static_cast<unsigned int>(faceVertexCount));
+	MIntArray faceList(faceIndices.data(), static_cast<unsigned int>(faceVertexCount));
+
+	MCHECK(mFnMesh.setFaceVertexNormals(mayaNormals, faceList, mayaVertexIndices));
 }
 
 constexpr unsigned int MATERIAL_MAX_STRING_LENGTH = 400;
@@ -230,39 +296,119 @@ adsk::Data::Structure* createNewMayaStructure(const prt::AttributeMap** material
 	return fStructure;
 }
 
+// a material key together with the structure members it is written to
+struct MaterialMember {
+	std::wstring key;
+	prt::Attributable::PrimitiveType type;
+	std::vector<unsigned int> memberIndices; // one per array element for string arrays
+};
+
+// the structure members of the material keys, resolved once per structure and key set
+struct MaterialLayout {
+	std::vector<std::pair<std::wstring, prt::Attributable::PrimitiveType>> keys; // of the materials it describes
+	unsigned int faceIndexStart = 0;
+	unsigned int faceIndexEnd = 0;
+	std::vector<MaterialMember> members;
+};
+using MaterialLayoutSPtr = std::shared_ptr<const MaterialLayout>;
+
+bool hasSameKeys(const MaterialLayout& layout, const prt::AttributeMap* mat) {
+	size_t keyCount = 0;
+	wchar_t const* const* keys = mat->getKeys(&keyCount);
+	if (keyCount != layout.keys.size())
+		return false;
+
+	for (size_t k = 0; k < keyCount; k++) {
+		if ((layout.keys[k].first != keys[k]) || (layout.keys[k].second != mat->getType(keys[k])))
+			return false;
+	}
+	return true;
+}
+
+MaterialLayoutSPtr createMaterialLayout(const adsk::Data::Structure& structure, const prt::AttributeMap* mat) {
+	std::unordered_map<std::string, unsigned int> memberIndices;
+	unsigned int memberIndex = 0;
+	for (const adsk::Data::Member& member : structure)
+		memberIndices.emplace(member.name(), memberIndex++);
+
+	auto layout = std::make_shared<MaterialLayout>();
+	layout->faceIndexStart = memberIndices.at(PRT_MATERIAL_FACE_INDEX_START);
+	layout->faceIndexEnd = memberIndices.at(PRT_MATERIAL_FACE_INDEX_END);
+
+	size_t keyCount = 0;
+	wchar_t const* const* keys = mat->getKeys(&keyCount);
+	layout->keys.reserve(keyCount);
+	layout->members.reserve(keyCount);
+	for (size_t k = 0; k < keyCount; k++) {
+		MaterialMember materialMember{keys[k], mat->getType(keys[k]), {}};
+		layout->keys.emplace_back(materialMember.key, materialMember.type);
+
+		const unsigned int arrayLength =
+		        (materialMember.type == prt::Attributable::PT_STRING_ARRAY) ? MATERIAL_MAX_STRING_ARRAY_LENGTH : 1;
+		for (unsigned int i = 0; i < arrayLength; i++) {
+			std::wstring keyToUse = materialMember.key;
+			if (i > 0)
+				keyToUse += std::to_wstring(i);
+			const auto it = memberIndices.find(prtu::toOSNarrowFromUTF16(keyToUse));
+			if (it == memberIndices.end())
+				break;
+			materialMember.memberIndices.push_back(it->second);
+		}
+
+		if (!materialMember.memberIndices.empty())
+			layout->members.push_back(std::move(materialMember));
+	}
+	return layout;
+}
+
+std::mutex materialLayoutsMutex;
+std::map<const adsk::Data::Structure*, MaterialLayoutSPtr> materialLayouts;
+
+// all materials have the same keys and types (see IMayaCallbacks::addMesh), the first one describes the layout
+MaterialLayoutSPtr getMaterialLayout(const adsk::Data::Structure& structure, const prt::AttributeMap* mat) {
+	std::lock_guard<std::mutex> lock(materialLayoutsMutex);
+	MaterialLayoutSPtr& layout = materialLayouts[&structure];
+	if (!layout || !hasSameKeys(*layout, mat))
+		layout = createMaterialLayout(structure, mat);
+	return layout;
+}
+
 void fillMetadata(adsk::Data::Structure* fStructure, const uint32_t* faceRanges, size_t faceRangesSize,
-                  const prt::AttributeMap** materials, const prt::AttributeMap** reports,
-                  adsk::Data::Associations& newMetadata) {
+                  const prt::AttributeMap** materials, adsk::Data::Associations& newMetadata) {
 	assert(fStructure != nullptr);
 	assert(faceRangesSize > 1);
 
 	adsk::Data::Stream newStream(*fStructure, PRT_MATERIAL_STREAM);
-	adsk::Data::Channel newChannel = newMetadata.channel(PRT_MATERIAL_CHANNEL);
-	newChannel.setDataStream(newStream);
-	newMetadata.setChannel(newChannel);
 
-	for (size_t fri = 0; fri < faceRangesSize - 1; fri++) {
+	if (materials != nullptr) {
+		const MaterialLayoutSPtr layoutPtr = getMaterialLayout(*fStructure, materials[0]);
+		const MaterialLayout& layout = *layoutPtr;
 
-		if (materials != nullptr) {
-			adsk::Data::Handle handle(*fStructure);
+		// every element overwrites all members written by the previous one,
+		// so a single handle serves as element buffer for the whole stream
+		adsk::Data::Handle handle(*fStructure);
 
-			const prt::AttributeMap* mat = materials[fri];
+		const auto setString = [&handle](const wchar_t* str) {
+			std::fill_n(handle.asUInt8(), MATERIAL_MAX_STRING_LENGTH, 0);
+			if (wcslen(str) == 0)
+				return;
+			checkStringLength(str, MATERIAL_MAX_STRING_LENGTH);
+			size_t maxStringLengthTmp = MATERIAL_MAX_STRING_LENGTH;
+			prt::StringUtils::toOSNarrowFromUTF16(str, (char*)handle.asUInt8(), &maxStringLengthTmp);
+		};
 
-			size_t keyCount = 0;
-			wchar_t const* const* keys = mat->getKeys(&keyCount);
-
-			for (int k = 0; k < keyCount; k++) {
-
-				wchar_t const* key = keys[k];
-
-				const std::string keyNarrow = prtu::toOSNarrowFromUTF16(key);
+		for (size_t fri = 0; fri < faceRangesSize - 1; fri++) {
+			const prt::AttributeMap* mat = materials[fri];
 
-				if (!handle.setPositionByMemberName(keyNarrow.c_str()))
+			// members which cannot be selected are skipped, otherwise they would overwrite the previous member
+			for (const MaterialMember& member : layout.members) {
+				wchar_t const* key = member.key.c_str();
+				if (!handle.setPositionByMemberIndex(member.memberIndices.front()))
 					continue;
 
 				size_t arraySize = 0;
 
-				switch (mat->getType(key)) {
+				switch (member.type) {
 					case prt::Attributable::PT_BOOL:
 						handle.asBoolean()[0] = mat->getBool(key);
 						break;
@@ -275,56 +421,38 @@ void fillMetadata(adsk::Data::Structure* fStructure, const uint32_t* faceRanges,
 
 					// workaround: transporting string as uint8 array, because using asString crashes maya
 					case prt::Attributable::PT_STRING: {
-						const wchar_t* str = mat->getString(key);
-						if (wcslen(str) == 0)
-							break;
-						checkStringLength(str, MATERIAL_MAX_STRING_LENGTH);
-						size_t maxStringLengthTmp = MATERIAL_MAX_STRING_LENGTH;
-						prt::StringUtils::toOSNarrowFromUTF16(str, (char*)handle.asUInt8(), &maxStringLengthTmp);
+						setString(mat->getString(key));
 						break;
 					}
 					case prt::Attributable::PT_BOOL_ARRAY: {
 						const bool* boolArray;
 						boolArray = mat->getBoolArray(key, &arraySize);
-						for (unsigned int i = 0; i < arraySize && i < MATERIAL_MAX_STRING_LENGTH; i++)
-							handle.asBoolean()[i] = boolArray[i];
+						for (unsigned int i = 0; i < MATERIAL_MAX_STRING_LENGTH; i++)
+							handle.asBoolean()[i] = (i < arraySize) && boolArray[i];
 						break;
 					}
 					case prt::Attributable::PT_INT_ARRAY: {
 						const int* intArray;
 						intArray = mat->getIntArray(key, &arraySize);
-						for (unsigned int i = 0; i < arraySize && i < MATERIAL_MAX_STRING_LENGTH; i++)
-							handle.asInt32()[i] = intArray[i];
+						for (unsigned int i = 0; i < MATERIAL_MAX_STRING_LENGTH; i++)
+							handle.asInt32()[i] = (i < arraySize) ? intArray[i] : 0;
 						break;
 					}
 					case prt::Attributable::PT_FLOAT_ARRAY: {
 						const double* floatArray;
 						floatArray = mat->getFloatArray(key, &arraySize);
-						for (unsigned int i = 0;
-						     i < arraySize && i < MATERIAL_MAX_STRING_LENGTH && i < MATERIAL_MAX_FLOAT_ARRAY_LENGTH;
-						     i++)
-							handle.asDouble()[i] = floatArray[i];
+						for (unsigned int i = 0; i < MATERIAL_MAX_FLOAT_ARRAY_LENGTH; i++)
+							handle.asDouble()[i] = (i < arraySize) ? floatArray[i] : 0.0;
 						break;
 					}
 					case prt::Attributable::PT_STRING_ARRAY: {
 
 						const wchar_t* const* stringArray = mat->getStringArray(key, &arraySize);
 
-						for (unsigned int i = 0; i < arraySize && i < MATERIAL_MAX_STRING_LENGTH; i++) {
-							if (wcslen(stringArray[i]) == 0)
-								continue;
-
-							if (i > 0) {
-								std::wstring keyToUse = key + std::to_wstring(i);
-								const std::string keyToUseNarrow = prtu::toOSNarrowFromUTF16(keyToUse);
-								if (!handle.setPositionByMemberName(keyToUseNarrow.c_str()))
-									continue;
-							}
-
-							checkStringLength(stringArray[i], MATERIAL_MAX_STRING_LENGTH);
-							size_t maxStringLengthTmp = MATERIAL_MAX_STRING_LENGTH;
-							prt::StringUtils::toOSNarrowFromUTF16(stringArray[i], (char*)handle.asUInt8(),
-							                                      &maxStringLengthTmp);
+						for (unsigned int i = 0; i < member.memberIndices.size(); i++) {
+							if ((i > 0) && !handle.setPositionByMemberIndex(member.memberIndices[i]))
+								break;
+							setString((i < arraySize) ? stringArray[i] : L"");
 						}
 						break;
 					}
@@ -340,44 +468,223 @@ void fillMetadata(adsk::Data::Structure* fStructure, const uint32_t* faceRanges,
 				}
 			}
 
-			handle.setPositionByMemberName(PRT_MATERIAL_FACE_INDEX_START.c_str());
+			if (!handle.setPositionByMemberIndex(layout.faceIndexStart))
+				continue;
 			*handle.asInt32() = faceRanges[fri];
 
-			handle.setPositionByMemberName(PRT_MATERIAL_FACE_INDEX_END.c_str());
+			if (!handle.setPositionByMemberIndex(layout.faceIndexEnd))
+				continue;
 			*handle.asInt32() = faceRanges[fri + 1];
 
 			newStream.setElement(static_cast<adsk::Data::IndexCount>(fri), handle);
 		}
+	}
+
+	// replaces the material channel shared from the input mesh (if any), which is only kept without materials
+	adsk::Data::Channel newChannel(PRT_MATERIAL_CHANNEL);
+	newChannel.setDataStream(newStream);
+	newMetadata.setChannel(newChannel);
+}
+
+adsk::Data::Structure* getReportStructure(const std::string& name, adsk::Data::Member::eDataType type,
+                                          unsigned int size, const std::vector<std::string>& memberNames) {
+	// the structure registry is global, the meshes of several initial shapes and nodes are created concurrently
+	std::lock_guard<std::mutex> lock(structureRegistryMutex);
+	adsk::Data::Structure* structure = adsk::Data::Structure::structureByName(name.c_str());
+
+	if (structure == nullptr) {
+		structure = adsk::Data::Structure::create();
+		structure->setName(name.c_str());
+		for (const std::string& memberName : memberNames)
+			structure->addMember(type, size, memberName.c_str());
+		adsk::Data::Structure::registerStructure(*structure);
+	}
+	return structure;
+}
+
+// appends str to a stream of PRT_REPORT_TEXT_STRUCTURE elements
+void appendReportText(adsk::Data::Stream& stream, adsk::Data::Handle& handle, const wchar_t* str) {
+	checkStringLength(str, REPORT_MAX_STRING_LENGTH);
+	std::fill_n(handle.asUInt8(), REPORT_MAX_STRING_LENGTH, 0);
+	size_t maxStringLengthTmp = REPORT_MAX_STRING_LENGTH;
+	prt::StringUtils::toOSNarrowFromUTF16(str, (char*)handle.asUInt8(), &maxStringLengthTmp);
+	stream.setElement(stream.elementCount(), handle);
+}
+
+// see ReportInfo.h for the layout
+void fillReportMetadata(const uint32_t* faceRanges, size_t faceRangesSize, const prt::AttributeMap** reports,
+                        adsk::Data::Associations& newMetadata) {
+	adsk::Data::Structure* textStructure =
+	        getReportStructure(PRT_REPORT_TEXT_STRUCTURE, adsk::Data::Member::kUInt8, REPORT_MAX_STRING_LENGTH,
+	                           {PRT_REPORT_VALUE});
+	adsk::Data::Structure* faceRangeStructure =
+	        getReportStructure(PRT_REPORT_FACE_RANGE_STRUCTURE, adsk::Data::Member::kInt32, 1,
+	                           {PRT_REPORT_FACE_INDEX_START, PRT_REPORT_FACE_INDEX_END});
+
+	struct ReportColumn {
+		prt::Attributable::PrimitiveType type;
+		adsk::Data::Stream stream;
+		adsk::Data::Handle handle;
+		bool hasTypeMismatch = false;
+	};
+	std::map<std::wstring, ReportColumn> columns;
+
+	adsk::Data::Stream keyStream(*textStructure, PRT_REPORT_KEY_STREAM);
+	adsk::Data::Stream stringStream(*textStructure, PRT_REPORT_STRING_STREAM);
+	adsk::Data::Handle textHandle(*textStructure);
+	std::unordered_map<std::wstring, int32_t> stringIndices;
+
+	adsk::Data::Stream faceRangeStream(*faceRangeStructure, PRT_REPORT_FACE_RANGE_STREAM);
+	adsk::Data::Handle faceRangeHandle(*faceRangeStructure);
+
+	for (size_t fri = 0; fri < faceRangesSize - 1; fri++) {
+		const auto elementIndex = static_cast<adsk::Data::IndexCount>(fri);
+
+		faceRangeHandle.setPositionByMemberName(PRT_REPORT_FACE_INDEX_START.c_str());
+		*faceRangeHandle.asInt32() = faceRanges[fri];
+		faceRangeHandle.setPositionByMemberName(PRT_REPORT_FACE_INDEX_END.c_str());
+		*faceRangeHandle.asInt32() = faceRanges[fri + 1];
+		faceRangeStream.setElement(elementIndex, faceRangeHandle);
+
+		const prt::AttributeMap* report = reports[fri];
+		if (report == nullptr)
+			continue;
+
+		size_t keyCount = 0;
+		wchar_t const* const* keys = report->getKeys(&keyCount);
+		for (size_t k = 0; k < keyCount; k++) {
+			const wchar_t* key = keys[k];
+			const prt::Attributable::PrimitiveType type = report->getType(key);
+
+			auto columnIt = columns.find(key);
+			if (columnIt == columns.end()) {
+				const std::string* structureName = nullptr;
+				adsk::Data::Member::eDataType dataType = adsk::Data::Member::kInt32;
+				switch (type) {
+					case prt::Attributable::PT_BOOL:
+						structureName = &PRT_REPORT_BOOL_STRUCTURE;
+						dataType = adsk::Data::Member::kBoolean;
+						break;
+					case prt::Attributable::PT_FLOAT:
+						structureName = &PRT_REPORT_FLOAT_STRUCTURE;
+						dataType = adsk::Data::Member::kDouble;
+						break;
+					case prt::Attributable::PT_STRING:
+						structureName = &PRT_REPORT_STRING_STRUCTURE;
+						break;
+					default:
+						break;
+				}
+				if (structureName == nullptr)
+					continue;
+
+				adsk::Data::Structure* structure = getReportStructure(*structureName, dataType, 1, {PRT_REPORT_VALUE});
+				const std::string streamName = PRT_REPORT_COLUMN_STREAM_PREFIX + prtu::toOSNarrowFromUTF16(key);
+				columnIt = columns.emplace(key, ReportColumn{type, adsk::Data::Stream(*structure, streamName),
+				                                             adsk::Data::Handle(*structure)})
+				                   .first;
+				appendReportText(keyStream, textHandle, key);
+			}
 
-		if (reports != nullptr) {
-			// todo
+			// the column type is defined by the first face range reporting the key
+			ReportColumn& column = columnIt->second;
+			if (column.type != type) {
+				if (!column.hasTypeMismatch)
+					LOG_WRN << "report '" << key << "' changes its type, only the values of the first type are kept";
+				column.hasTypeMismatch = true;
+				continue;
+			}
+
+			switch (type) {
+				case prt::Attributable::PT_BOOL:
+					column.handle.asBoolean()[0] = report->getBool(key);
+					break;
+				case prt::Attributable::PT_FLOAT:
+					column.handle.asDouble()[0] = report->getFloat(key);
+					break;
+				case prt::Attributable::PT_STRING: {
+					const wchar_t* str = report->getString(key);
+					const auto [stringIt, wasInserted] =
+					        stringIndices.try_emplace(str, static_cast<int32_t>(stringIndices.size()));
+					if (wasInserted)
+						appendReportText(stringStream, textHandle, str);
+					column.handle.asInt32()[0] = stringIt->second;
+					break;
+				}
+				default:
+					break;
+			}
+			column.stream.setElement(elementIndex, column.handle);
 		}
 	}
+
+	if (columns.empty())
+		return;
+
+	adsk::Data::Channel newChannel = newMetadata.channel(PRT_REPORT_CHANNEL);
+	newChannel.setDataStream(faceRangeStream);
+	newChannel.setDataStream(keyStream);
+	newChannel.setDataStream(stringStream);
+	for (auto& [key, column] : columns)
+		newChannel.setDataStream(column.stream);
+	newMetadata.setChannel(newChannel);
+}
+
+// everything of a generated mesh besides its points and normals, i.e. what setPoints() cannot change
+uint64_t getTopologyHash(const uint32_t* faceCounts, size_t faceCountsSize, const uint32_t* vertexIndices,
+                         size_t vertexIndicesSize, double const* const* uvs, size_t const* uvsSizes,
+                         uint32_t const* const* uvCounts, size_t const* uvCountsSizes, uint32_t const* const* uvIndices,
+                         size_t const* uvIndicesSizes, size_t uvSetsCount, bool hasNormals,
+                         bool normalsAsHardEdges) {
+	prtu::Fnv1aHash hash;
+
+	const auto addArray = [&hash](const auto* data, size_t size) {
+		hash.add(size);
+		if (size > 0)
+			hash.add(data, size * sizeof(*data));
+	};
+	addArray(faceCounts, faceCountsSize);
+	addArray(vertexIndices, vertexIndicesSize);
+	hash.add(uvSetsCount);
+	for (size_t uvSet = 0; uvSet < uvSetsCount; uvSet++) {
+		addArray(uvs[uvSet], uvsSizes[uvSet]);
+		addArray(uvCounts[uvSet], uvCountsSizes[uvSet]);
+		addArray(uvIndices[uvSet], uvIndicesSizes[uvSet]);
+	}
+	hash.add(hasNormals);
+	hash.add(normalsAsHardEdges);
+	return hash.value();
 }
 
 void updateMayaMesh(double const* const* uvs, size_t const* uvsSizes, uint32_t const* const* uvCounts,
                     size_t const* uvCountsSizes, uint32_t const* const* uvIndices, size_t const* uvIndicesSizes,
                     size_t uvSetsCount, const double* nrm, size_t nrmSize, const uint32_t* normalIndices,
                     size_t normalIndicesSize, const MFloatPointArray& mayaVertices, const MIntArray& mayaFaceCounts,
-                    MIntArray& mayaVertexIndices, const MObject& outMeshObj,
-                    const adsk::Data::Associations& newMetadata) {
+                    MIntArray& mayaVertexIndices, bool normalsAsHardEdges, bool sameTopology,
+                    const MObject& outMeshObj, const adsk::Data::Associations& newMetadata) {
 	MStatus stat;
 
-	MFnMeshData dataCreator;
-	MObject newOutputData = dataCreator.create(&stat);
-	MCHECK(stat);
+	// the counts guard against an output mesh which was replaced behind our back
+	MFnMesh outputMesh(outMeshObj, &stat);
+	const bool updatePointsOnly = sameTopology && (stat == MS::kSuccess) &&
+	                              (outputMesh.numVertices() == static_cast<int>(mayaVertices.length())) &&
+	                              (outputMesh.numPolygons() == static_cast<int>(mayaFaceCounts.length())) &&
+	                              (outputMesh.numFaceVertices() == static_cast<int>(mayaVertexIndices.length()));
 
-	MFnMesh mFnMesh1;
-	MObject newMeshObj = mFnMesh1.create(mayaVertices.length(), mayaFaceCounts.length(), mayaVertices, mayaFaceCounts,
-	                                     mayaVertexIndices, newOutputData, &stat);
-	MCHECK(stat);
-
-	MFnMesh newMesh(newMeshObj);
-	assignTextureCoordinates(newMesh, uvs, uvsSizes, uvCounts, uvCountsSizes, uvIndices, uvIndicesSizes, uvSetsCount);
-	assignVertexNormals(newMesh, mayaFaceCounts, mayaVertexIndices, nrm, nrmSize, normalIndices, normalIndicesSize);
-
-	MFnMesh outputMesh(outMeshObj);
-	outputMesh.copyInPlace(newMeshObj);
+	if (updatePointsOnly) {
+		MCHECK(outputMesh.setPoints(mayaVertices));
+	}
+	else {
+		// outMeshObj is mesh data, creating the mesh with it as owner replaces its geometry without a copy
+		outputMesh.create(mayaVertices.length(), mayaFaceCounts.length(), mayaVertices, mayaFaceCounts,
+		                  mayaVertexIndices, outMeshObj, &stat);
+		MCHECK(stat);
+
+		assignTextureCoordinates(outputMesh, uvs, uvsSizes, uvCounts, uvCountsSizes, uvIndices, uvIndicesSizes,
+		                         uvSetsCount);
+	}
+	assignVertexNormals(outputMesh, mayaFaceCounts, mayaVertexIndices, nrm, nrmSize, normalIndices, normalIndicesSize,
+	                    normalsAsHardEdges);
 
 	outputMesh.setMetadata(newMetadata);
 }
@@ -393,10 +700,10 @@ void copyStringToWCharPtr(const std::wstring input, wchar_t* result, size_t& res
 }
 
 std::filesystem::path getAssetDir() {
-	MStatus status;
-	const std::filesystem::path workspaceRoot = mu::getWorkspaceRoot(status);
+	// the callbacks run on compute and PRT worker threads where we cannot query the workspace with MEL
+	const std::filesystem::path workspaceRoot = mu::getCachedWorkspaceRoot();
 
-	if (status != MS::kSuccess)
+	if (workspaceRoot.empty())
 		return {};
 
 	std::filesystem::path assetDir = workspaceRoot / MAYA_ASSET_FOLDER / SERLIO_ASSET_FOLDER;
@@ -428,72 +735,153 @@ void detectAndAppendCGACErrors(prt::CGAErrorLevel level, const wchar_t* message,
 }
 } // namespace
 
-prt::Status MayaCallbacks::generateError(size_t /*isIndex*/, prt::Status /*status*/, const wchar_t* message) {
+void MayaCallbacks::appendCGACError(size_t initialShapeIndex, prt::CGAErrorLevel level, const wchar_t* message) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	if (initialShapeIndex < cgacErrors.size())
+		detectAndAppendCGACErrors(level, message, cgacErrors[initialShapeIndex]);
+}
+
+bool MayaCallbacks::isCanceled(size_t initialShapeIndex) const {
+	if (initialShapeIndex >= mCancelFlags.size() || mCancelFlags[initialShapeIndex] == nullptr)
+		return false;
+	return mCancelFlags[initialShapeIndex]->load();
+}
+
+bool MayaCallbacks::getFaceNormalsAsHardEdges(size_t initialShapeIndex) const {
+	return (initialShapeIndex < mFaceNormalsAsHardEdges.size()) && mFaceNormalsAsHardEdges[initialShapeIndex];
+}
+
+std::optional<uint64_t> MayaCallbacks::getGeneratedTopology(size_t initialShapeIndex) const {
+	if (initialShapeIndex >= mGeneratedTopologies.size())
+		return {};
+	return mGeneratedTopologies[initialShapeIndex];
+}
+
+prt::Status MayaCallbacks::getCallbackStatus(size_t initialShapeIndex) const {
+	return isCanceled(initialShapeIndex) ? STATUS_CANCELED : prt::STATUS_OK;
+}
+
+prt::Status MayaCallbacks::generateError(size_t isIndex, prt::Status /*status*/, const wchar_t* message) {
 	LOG_ERR << "GENERATE ERROR: " << message;
-	detectAndAppendCGACErrors(prt::CGAErrorLevel::CGAERROR, message, cgacErrors);
-	return prt::STATUS_OK;
+	appendCGACError(isIndex, prt::CGAErrorLevel::CGAERROR, message);
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (isIndex < mGenerateFailed.size())
+			mGenerateFailed[isIndex] = true;
+	}
+	return getCallbackStatus(isIndex);
 }
 
-prt::Status MayaCallbacks::assetError(size_t /*isIndex*/, prt::CGAErrorLevel level, const wchar_t* /*key*/,
+prt::Status MayaCallbacks::assetError(size_t isIndex, prt::CGAErrorLevel level, const wchar_t* /*key*/,
                                       const wchar_t* /*uri*/, const wchar_t* message) {
 	LOG_ERR << "ASSET ERROR: " << message;
-	detectAndAppendCGACErrors(level, message, cgacErrors);
-	return prt::STATUS_OK;
+	appendCGACError(isIndex, level, message);
+	return getCallbackStatus(isIndex);
 }
 
-prt::Status MayaCallbacks::cgaError(size_t /*isIndex*/, int32_t /*shapeID*/, prt::CGAErrorLevel level,
+prt::Status MayaCallbacks::cgaError(size_t isIndex, int32_t /*shapeID*/, prt::CGAErrorLevel level,
                                     int32_t /*methodId*/, int32_t /*pc*/, const wchar_t* message) {
 	LOG_ERR << "CGA ERROR: " << message;
-	detectAndAppendCGACErrors(level, message, cgacErrors);
-	return prt::STATUS_OK;
+	appendCGACError(isIndex, level, message);
+	return getCallbackStatus(isIndex);
 }
 
-prt::Status MayaCallbacks::cgaPrint(size_t /*isIndex*/, int32_t /*shapeID*/, const wchar_t* txt) {
+prt::Status MayaCallbacks::cgaPrint(size_t isIndex, int32_t /*shapeID*/, const wchar_t* txt) {
 	LOG_INF << "CGA PRINT: " << txt;
-	return prt::STATUS_OK;
+	return getCallbackStatus(isIndex);
 }
 
-prt::Status MayaCallbacks::cgaReportBool(size_t /*isIndex*/, int32_t /*shapeID*/, const wchar_t* /*key*/,
+prt::Status MayaCallbacks::cgaReportBool(size_t isIndex, int32_t /*shapeID*/, const wchar_t* /*key*/,
                                          bool /*value*/) {
-	return prt::STATUS_OK;
+	return getCallbackStatus(isIndex);
 }
 
-prt::Status MayaCallbacks::cgaReportFloat(size_t /*isIndex*/, int32_t /*shapeID*/, const wchar_t* /*key*/,
+prt::Status MayaCallbacks::cgaReportFloat(size_t isIndex, int32_t /*shapeID*/, const wchar_t* /*key*/,
                                           double /*value*/) {
-	return prt::STATUS_OK;
+	return getCallbackStatus(isIndex);
 }
 
-prt::Status MayaCallbacks::cgaReportString(size_t /*isIndex*/, int32_t /*shapeID*/, const wchar_t* /*key*/,
+prt::Status MayaCallbacks::cgaReportString(size_t isIndex, int32_t /*shapeID*/, const wchar_t* /*key*/,
                                            const wchar_t* /*value*/) {
-	return prt::STATUS_OK;
+	return getCallbackStatus(isIndex);
 }
 
-const CGACErrors& MayaCallbacks::getCGACErrors() const {
-	return cgacErrors;
+const CGACErrors& MayaCallbacks::getCGACErrors(size_t initialShapeIndex) const {
+	return cgacErrors.at(initialShapeIndex);
 }
 
-void MayaCallbacks::addMesh(const wchar_t*, const double* vtx, size_t vtxSize, const double* nrm, size_t nrmSize,
-                            const uint32_t* faceCounts, size_t faceCountsSize, const uint32_t* vertexIndices,
-                            size_t vertexIndicesSize, const uint32_t* normalIndices, size_t normalIndicesSize,
-                            double const* const* uvs, size_t const* uvsSizes, uint32_t const* const* uvCounts,
-                            size_t const* uvCountsSizes, uint32_t const* const* uvIndices, size_t const* uvIndicesSizes,
-                            size_t uvSetsCount, const uint32_t* faceRanges, size_t faceRangesSize,
-                            const prt::AttributeMap** materials, const prt::AttributeMap** reports, const int32_t*) {
-	MStatus stat;
-	adsk::Data::Structure* fStructure = adsk::Data::Structure::structureByName(PRT_MATERIAL_STRUCTURE.c_str());
+void MayaCallbacks::collectAttributesPerInitialShape() {
+	mInitialShapeAttributeBuilders.clear();
+	for (size_t i = 0; i < cgacErrors.size(); i++)
+		mInitialShapeAttributeBuilders.emplace_back(prt::AttributeMapBuilder::create());
+}
+
+AttributeMapUPtr MayaCallbacks::createAttributeMap(size_t initialShapeIndex) {
+	return AttributeMapUPtr(getAttributeMapBuilder(initialShapeIndex).createAttributeMapAndReset());
+}
+
+prt::AttributeMapBuilder& MayaCallbacks::getAttributeMapBuilder(size_t initialShapeIndex) {
+	if (initialShapeIndex < mInitialShapeAttributeBuilders.size())
+		return *mInitialShapeAttributeBuilders[initialShapeIndex];
+	return *mAttributeMapBuilder;
+}
+
+bool MayaCallbacks::hasGenerateFailed(size_t initialShapeIndex) const {
+	return (initialShapeIndex < mGenerateFailed.size()) && mGenerateFailed[initialShapeIndex];
+}
+
+void MayaCallbacks::addMesh(size_t initialShapeIndex, const wchar_t*, const double* vtx, size_t vtxSize,
+                            const double* nrm, size_t nrmSize, const uint32_t* faceCounts, size_t faceCountsSize,
+                            const uint32_t* vertexIndices, size_t vertexIndicesSize, const uint32_t* normalIndices,
+                            size_t normalIndicesSize, double const* const* uvs, size_t const* uvsSizes,
+                            uint32_t const* const* uvCounts, size_t const* uvCountsSizes,
+                            uint32_t const* const* uvIndices, size_t const* uvIndicesSizes, size_t uvSetsCount,
+                            const uint32_t* faceRanges, size_t faceRangesSize, const prt::AttributeMap** materials,
+                            const prt::AttributeMap** reports, const int32_t*) {
+	if (initialShapeIndex >= outMeshObjs.size()) {
+		LOG_ERR << "no output mesh for initial shape " << initialShapeIndex;
+		return;
+	}
+	if (isCanceled(initialShapeIndex))
+		return;
+	const MObject& inMeshObj = inMeshObjs[initialShapeIndex];
+	const MObject& outMeshObj = outMeshObjs[initialShapeIndex];
 
-	if ((fStructure == nullptr) && (materials != nullptr) && (faceRangesSize > 1)) {
-		fStructure = createNewMayaStructure(materials); // Structure to use for creation
+	MStatus stat;
+	adsk::Data::Structure* fStructure = nullptr;
+	{
+		// the structure registry is global, the meshes of several initial shapes and nodes are created concurrently
+		std::lock_guard<std::mutex> lock(structureRegistryMutex);
+		fStructure = adsk::Data::Structure::structureByName(PRT_MATERIAL_STRUCTURE.c_str());
+
+		if ((fStructure == nullptr) && (materials != nullptr) && (faceRangesSize > 1)) {
+			fStructure = createNewMayaStructure(materials); // Structure to use for creation
+		}
 	}
 
 	MFnMesh inputMesh(inMeshObj);
 
-	adsk::Data::Associations newMetadata(inputMesh.metadata(&stat));
-	newMetadata.makeUnique();
+	const bool hasMaterials = (fStructure != nullptr) && (faceRangesSize > 1);
+	const bool hasReports = (reports != nullptr) && (faceRangesSize > 1);
+
+	// instead of a deep copy of the input metadata, share its channels except for the ones serlio replaces
+	adsk::Data::Associations newMetadata;
+	const adsk::Data::Associations* inputMetadata = inputMesh.metadata(&stat);
 	MCHECK(stat);
+	if (inputMetadata != nullptr) {
+		for (const auto& channel : *inputMetadata) {
+			const bool isReplaced = (channel.name() == PRT_REPORT_CHANNEL) ||
+			                        (hasMaterials && (channel.name() == PRT_MATERIAL_CHANNEL));
+			if (!isReplaced)
+				newMetadata.setChannel(channel);
+		}
+	}
 
-	if (fStructure != nullptr && faceRangesSize > 1) {
-		fillMetadata(fStructure, faceRanges, faceRangesSize, materials, reports, newMetadata);
+	if (hasMaterials) {
+		fillMetadata(fStructure, faceRanges, faceRangesSize, materials, newMetadata);
+	}
+	if (hasReports) {
+		fillReportMetadata(faceRanges, faceRangesSize, reports, newMetadata);
 	}
 
 	MFloatPointArray mayaVertices = toMayaFloatPointArray(vtx, vtxSize);
@@ -509,27 +897,66 @@ void MayaCallbacks::addMesh(const wchar_t*, const double* vtx, size_t vtxSize, c
 		LOG_DBG << "   mayaVertexIndices.length = " << mayaVertexIndices.length();
 	}
 
+	// the normal mode is part of the topology, a points only update cannot switch between hard edges and locked normals
+	const bool normalsAsHardEdges = (nrmSize > 0) && getFaceNormalsAsHardEdges(initialShapeIndex) &&
+	                                hasOnlyFaceNormals(mayaFaceCounts, nrm, normalIndices);
+	const uint64_t topology =
+	        getTopologyHash(faceCounts, faceCountsSize, vertexIndices, vertexIndicesSize, uvs, uvsSizes, uvCounts,
+	                        uvCountsSizes, uvIndices, uvIndicesSizes, uvSetsCount, nrmSize > 0, normalsAsHardEdges);
+	const bool sameTopology =
+	        (initialShapeIndex < mOutMeshTopologies.size()) && (mOutMeshTopologies[initialShapeIndex] == topology);
+
 	updateMayaMesh(uvs, uvsSizes, uvCounts, uvCountsSizes, uvIndices, uvIndicesSizes, uvSetsCount, nrm, nrmSize,
-	               normalIndices, normalIndicesSize, mayaVertices, mayaFaceCounts, mayaVertexIndices, outMeshObj,
-	               newMetadata);
+	               normalIndices, normalIndicesSize, mayaVertices, mayaFaceCounts, mayaVertexIndices,
+	               normalsAsHardEdges, sameTopology, outMeshObj, newMetadata);
+
+	if (initialShapeIndex < mGeneratedTopologies.size())
+		mGeneratedTopologies[initialShapeIndex] = topology;
 }
 
-prt::Status MayaCallbacks::attrBool(size_t /*isIndex*/, int32_t /*shapeID*/, const wchar_t* key, bool value) {
-	mAttributeMapBuilder->setBool(key, value);
+prt::Status MayaCallbacks::attrBool(size_t isIndex, int32_t /*shapeID*/, const wchar_t* key, bool value) {
+	getAttributeMapBuilder(isIndex).setBool(key, value);
 	return prt::STATUS_OK;
 }
 
-prt::Status MayaCallbacks::attrFloat(size_t /*isIndex*/, int32_t /*shapeID*/, const wchar_t* key, double value) {
-	mAttributeMapBuilder->setFloat(key, value);
+prt::Status MayaCallbacks::attrFloat(size_t isIndex, int32_t /*shapeID*/, const wchar_t* key, double value) {
+	getAttributeMapBuilder(isIndex).setFloat(key, value);
 	return prt::STATUS_OK;
 }
 
-prt::Status MayaCallbacks::attrString(size_t /*isIndex*/, int32_t /*shapeID*/, const wchar_t* key,
+prt::Status MayaCallbacks::attrString(size_t isIndex, int32_t /*shapeID*/, const wchar_t* key,
                                       const wchar_t* value) {
-	mAttributeMapBuilder->setString(key, value);
+	getAttributeMapBuilder(isIndex).setString(key, value);
 	return prt::STATUS_OK;
 }
 
+void MayaCallbacks::addAttributes(size_t initialShapeIndex, int32_t /*shapeID*/, const prt::AttributeMap* attributes) {
+	if (attributes == nullptr)
+		return;
+
+	// same as the attr* callbacks, but for all keys at once and safe for concurrently encoded initial shapes
+	std::lock_guard<std::mutex> lock(mMutex);
+	prt::AttributeMapBuilder& attributeMapBuilder = getAttributeMapBuilder(initialShapeIndex);
+	size_t keyCount = 0;
+	wchar_t const* const* keys = attributes->getKeys(&keyCount);
+	for (size_t k = 0; k < keyCount; k++) {
+		const wchar_t* key = keys[k];
+		switch (attributes->getType(key)) {
+			case prt::Attributable::PT_BOOL:
+				attributeMapBuilder.setBool(key, attributes->getBool(key));
+				break;
+			case prt::Attributable::PT_FLOAT:
+				attributeMapBuilder.setFloat(key, attributes->getFloat(key));
+				break;
+			case prt::Attributable::PT_STRING:
+				attributeMapBuilder.setString(key, attributes->getString(key));
+				break;
+			default:
+				break;
+		}
+	}
+}
+
 void MayaCallbacks::addAsset(const wchar_t* uri, const wchar_t* fileName, const uint8_t* buffer, size_t size,
                              wchar_t* result, size_t& resultSize) {
 	if (uri == nullptr || std::wcslen(uri) == 0 || fileName == nullptr || std::wcslen(fileName) == 0) {
@@ -562,42 +989,42 @@ void MayaCallbacks::addAsset(const wchar_t* uri, const wchar_t* fileName, const
 // PRT version >= 2.3
 #if PRT_VERSION_GTE(2, 3)
 
-prt::Status MayaCallbacks::attrBoolArray(size_t /*isIndex*/, int32_t /*shapeID*/, const wchar_t* key,
+prt::Status MayaCallbacks::attrBoolArray(size_t isIndex, int32_t /*shapeID*/, const wchar_t* key,
                                          const bool* values, size_t size, size_t /*nRows*/) {
-	mAttributeMapBuilder->setBoolArray(key, values, size);
+	getAttributeMapBuilder(isIndex).setBoolArray(key, values, size);
 	return prt::STATUS_OK;
 }
 
-prt::Status MayaCallbacks::attrFloatArray(size_t /*isIndex*/, int32_t /*shapeID*/, const wchar_t* key,
+prt::Status MayaCallbacks::attrFloatArray(size_t isIndex, int32_t /*shapeID*/, const wchar_t* key,
                                           const double* values, size_t size, size_t /*nRows*/) {
-	mAttributeMapBuilder->setFloatArray(key, values, size);
+	getAttributeMapBuilder(isIndex).setFloatArray(key, values, size);
 	return prt::STATUS_OK;
 }
 
-prt::Status MayaCallbacks::attrStringArray(size_t /*isIndex*/, int32_t /*shapeID*/, const wchar_t* key,
+prt::Status MayaCallbacks::attrStringArray(size_t isIndex, int32_t /*shapeID*/, const wchar_t* key,
                                            const wchar_t* const* values, size_t size, size_t /*nRows*/) {
-	mAttributeMapBuilder->setStringArray(key, values, size);
+	getAttributeMapBuilder(isIndex).setStringArray(key, values, size);
 	return prt::STATUS_OK;
 }
 
 // PRT version >= 2.1
 #elif PRT_VERSION_GTE(2, 1)
 
-prt::Status MayaCallbacks::attrBoolArray(size_t /*isIndex*/, int32_t /*shapeID*/, const wchar_t* key,
+prt::Status MayaCallbacks::attrBoolArray(size_t isIndex, int32_t /*shapeID*/, const wchar_t* key,
                                          const bool* values, size_t size) {
-	mAttributeMapBuilder->setBoolArray(key, values, size);
+	getAttributeMapBuilder(isIndex).setBoolArray(key, values, size);
 	return prt::STATUS_OK;
 }
 
-prt::Status MayaCallbacks::attrFloatArray(size_t /*isIndex*/, int32_t /*shapeID*/, const wchar_t* key,
+prt::Status MayaCallbacks::attrFloatArray(size_t isIndex, int32_t /*shapeID*/, const wchar_t* key,
                                           const double* values, size_t size) {
-	mAttributeMapBuilder->setFloatArray(key, values, size);
+	getAttributeMapBuilder(isIndex).setFloatArray(key, values, size);
 	return prt::STATUS_OK;
 }
 
-prt::Status MayaCallbacks::attrStringArray(size_t /*isIndex*/, int32_t /*shapeID*/, const wchar_t* key,
+prt::Status MayaCallbacks::attrStringArray(size_t isIndex, int32_t /*shapeID*/, const wchar_t* key,
                                            const wchar_t* const* values, size_t size) {
-	mAttributeMapBuilder->setStringArray(key, values, size);
+	getAttributeMapBuilder(isIndex).setStringArray(key, values, size);
 	return prt::STATUS_OK;
 }
 
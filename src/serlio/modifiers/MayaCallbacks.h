@@ -26,9 +26,13 @@
 
 #include "maya/MObject.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -54,7 +58,13 @@ using CGACErrors = std::map<CGACError, uint32_t>;
 class MayaCallbacks : public IMayaCallbacks {
 public:
 	MayaCallbacks(const MObject& inMesh, const MObject& outMesh, AttributeMapBuilderUPtr& amb)
-	    : inMeshObj(inMesh), outMeshObj(outMesh), mAttributeMapBuilder(amb) {}
+	    : MayaCallbacks(std::vector<MObject>{inMesh}, std::vector<MObject>{outMesh}, amb) {}
+
+	// one input and output mesh per initial shape, in the order of the initial shapes passed to prt::generate
+	MayaCallbacks(std::vector<MObject> inMeshes, std::vector<MObject> outMeshes, AttributeMapBuilderUPtr& amb)
+	    : inMeshObjs(std::move(inMeshes)), outMeshObjs(std::move(outMeshes)),
+	      cgacErrors(std::max<size_t>(inMeshObjs.size(), 1)), mGenerateFailed(cgacErrors.size(), false),
+	      mAttributeMapBuilder(amb) {}
 
 	// prt::Callbacks interface
 	prt::Status generateError(size_t /*isIndex*/, prt::Status /*status*/, const wchar_t* message) override;
@@ -96,10 +106,39 @@ public:
 
 #endif // PRT version >= 2.1
 
-	const CGACErrors& getCGACErrors() const;
+	const CGACErrors& getCGACErrors(size_t initialShapeIndex = 0) const;
+	// true if PRT reported a generate error for the initial shape
+	bool hasGenerateFailed(size_t initialShapeIndex) const;
+
+	// collect the evaluated attributes of each initial shape separately instead of in the builder passed to the
+	// constructor, e.g. to evaluate the default attribute values of several initial shapes with one generate call
+	void collectAttributesPerInitialShape();
+	// the attributes collected for the initial shape, resets its builder
+	AttributeMapUPtr createAttributeMap(size_t initialShapeIndex);
+
+	// optional cancellation flag per initial shape (may be null), polled by the callbacks and the encoder
+	void setCancelFlags(std::vector<const std::atomic<bool>*> cancelFlags) {
+		mCancelFlags = std::move(cancelFlags);
+	}
+	bool isCanceled(size_t initialShapeIndex) const override;
+
+	// per initial shape: replace the normals by hard edges if all faces only have a single normal
+	void setFaceNormalsAsHardEdges(std::vector<bool> faceNormalsAsHardEdges) {
+		mFaceNormalsAsHardEdges = std::move(faceNormalsAsHardEdges);
+	}
+
+	// per initial shape: topology hash of the generated mesh the output mesh still holds (if any), a new mesh with the
+	// same topology only updates its points and normals
+	void setOutMeshTopologies(std::vector<std::optional<uint64_t>> outMeshTopologies) {
+		mGeneratedTopologies.assign(outMeshTopologies.size(), std::nullopt);
+		mOutMeshTopologies = std::move(outMeshTopologies);
+	}
+	// topology hash of the mesh written to the output mesh, empty if no mesh was added
+	std::optional<uint64_t> getGeneratedTopology(size_t initialShapeIndex) const;
 
 	// clang-format off
-	void addMesh(const wchar_t* name,
+	void addMesh(size_t initialShapeIndex,
+	                     const wchar_t* name,
 	                     const double* vtx, size_t vtxSize,
 	                     const double* nrm, size_t nrmSize,
 	                     const uint32_t* faceCounts, size_t faceCountsSize,
@@ -120,10 +159,29 @@ public:
 	void addAsset(const wchar_t* uri, const wchar_t* fileName, const uint8_t* buffer, size_t size, wchar_t* result,
 	              size_t& resultSize) override;
 
+	void addAttributes(size_t initialShapeIndex, int32_t shapeID, const prt::AttributeMap* attributes) override;
+
 private:
-	CGACErrors cgacErrors;
-	MObject outMeshObj;
-	MObject inMeshObj;
+	void appendCGACError(size_t initialShapeIndex, prt::CGAErrorLevel level, const wchar_t* message);
+	prt::Status getCallbackStatus(size_t initialShapeIndex) const;
+	bool getFaceNormalsAsHardEdges(size_t initialShapeIndex) const;
+	prt::AttributeMapBuilder& getAttributeMapBuilder(size_t initialShapeIndex);
+
+	const std::vector<MObject> inMeshObjs;
+	const std::vector<MObject> outMeshObjs;
+
+	// PRT invokes the callbacks of different initial shapes from its worker threads
+	std::mutex mMutex;
+	std::vector<CGACErrors> cgacErrors;
+	std::vector<bool> mGenerateFailed;
+
+	std::vector<const std::atomic<bool>*> mCancelFlags;
+	std::vector<bool> mFaceNormalsAsHardEdges;
+	std::vector<std::optional<uint64_t>> mOutMeshTopologies;
+	std::vector<std::optional<uint64_t>> mGeneratedTopologies; // each initial shape only writes its own entry
 
+	// only meaningful for attribute evaluation of a single initial shape
 	AttributeMapBuilderUPtr& mAttributeMapBuilder;
+	// one per initial shape if set by collectAttributesPerInitialShape(), each initial shape only uses its own
+	std::vector<AttributeMapBuilderUPtr> mInitialShapeAttributeBuilders;
 };
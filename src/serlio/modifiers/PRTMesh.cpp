@@ -21,6 +21,7 @@
 
 #include "utils/MArrayWrapper.h"
 #include "utils/MayaUtilities.h"
+#include "utils/Utilities.h"
 
 #include "maya/MFloatPointArray.h"
 #include "maya/MFnMesh.h"
@@ -59,4 +60,12 @@ PRTMesh::PRTMesh(const MObject& mesh) {
 	mIndicesVec.reserve(vertexList.length());
 	const auto vertexListWrapper = mu::makeMArrayConstWrapper(vertexList);
 	std::copy(vertexListWrapper.begin(), vertexListWrapper.end(), std::back_inserter(mIndicesVec));
+
+	prtu::Fnv1aHash hash;
+	hash.add(mVertexCoordsVec.size());
+	hash.add(mVertexCoordsVec.data(), mVertexCoordsVec.size() * sizeof(double));
+	hash.add(mFaceCountsVec.size());
+	hash.add(mFaceCountsVec.data(), mFaceCountsVec.size() * sizeof(uint32_t));
+	hash.add(mIndicesVec.data(), mIndicesVec.size() * sizeof(uint32_t));
+	mHash = hash.value();
 }
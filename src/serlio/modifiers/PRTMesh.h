@@ -22,6 +22,7 @@
 #include "maya/MTypes.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 
 class PRTMesh {
@@ -30,6 +31,7 @@ private:
 	std::vector<double> mVertexCoordsVec;
 	std::vector<uint32_t> mIndicesVec;
 	std::vector<uint32_t> mFaceCountsVec;
+	uint64_t mHash = 0;
 
 public:
 	explicit PRTMesh(const MObject& mesh);
@@ -57,4 +59,9 @@ public:
 	size_t faceCountsCount() const noexcept {
 		return mFaceCountsVec.size();
 	}
+
+	// hash of the vertex coordinates and the face topology
+	uint64_t hash() const noexcept {
+		return mHash;
+	}
 };
@@ -18,6 +18,7 @@
  */
 
 #include "modifiers/PRTModifierAction.h"
+#include "modifiers/GenerateScheduler.h"
 #include "modifiers/PRTModifierCommand.h"
 #include "modifiers/RuleAttributes.h"
 
@@ -31,13 +32,18 @@
 #include "maya/MFloatPointArray.h"
 #include "maya/MFnCompoundAttribute.h"
 #include "maya/MFnMesh.h"
+#include "maya/MFnMeshData.h"
 #include "maya/MFnNumericAttribute.h"
 #include "maya/MFnStringArrayData.h"
 #include "maya/MFnStringData.h"
 #include "maya/MFnTypedAttribute.h"
 #include "maya/MGlobal.h"
+#include "maya/MUuid.h"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <iterator>
 
 namespace {
 
@@ -50,6 +56,10 @@ constexpr const wchar_t* ENC_ID_CGA_PRINT = L"com.esri.prt.core.CGAPrintEncoder"
 constexpr const wchar_t* FILE_CGA_ERROR = L"CGAErrors.txt";
 constexpr const wchar_t* FILE_CGA_PRINT = L"CGAPrint.txt";
 
+// rules can declare this float attribute to reduce their detail, it is set to 0 if the node does not generate in full
+// detail
+constexpr const wchar_t* RULE_ATTRIBUTE_LOD = L"LOD";
+
 constexpr const wchar_t* NULL_KEY = L"#NULL#";
 constexpr const wchar_t* MIN_KEY = L"min";
 constexpr const wchar_t* MAX_KEY = L"max";
@@ -103,166 +113,188 @@ RangeType GetRangeType(const prt::Annotation* an) {
 	return RangeType::INVALID;
 }
 
+const prt::AttributeMap* getAttrEvalEncoderOptions() {
+	static const AttributeMapUPtr attrEncOpts = prtu::createValidatedOptions(ENC_ID_ATTR_EVAL);
+	return attrEncOpts.get();
+}
+
+// isb and amb are reused across calls, both are reset when this returns
 AttributeMapUPtr getDefaultAttributeValues(const std::wstring& ruleFile, const std::wstring& startRule,
                                            const prt::ResolveMap& resolveMap, prt::CacheObject& cache,
                                            const PRTMesh& prtMesh, const int32_t seed,
-                                           const prt::AttributeMap& attributeMap) {
-	AttributeMapBuilderUPtr mayaCallbacksAttributeBuilder(prt::AttributeMapBuilder::create());
-	MayaCallbacks mayaCallbacks(MObject::kNullObj, MObject::kNullObj, mayaCallbacksAttributeBuilder);
-
-	InitialShapeBuilderUPtr isb(prt::InitialShapeBuilder::create());
+                                           const prt::AttributeMap& attributeMap, prt::InitialShapeBuilder& isb,
+                                           AttributeMapBuilderUPtr& amb) {
+	MayaCallbacks mayaCallbacks(MObject::kNullObj, MObject::kNullObj, amb);
 
-	isb->setGeometry(prtMesh.vertexCoords(), prtMesh.vcCount(), prtMesh.indices(), prtMesh.indicesCount(),
-	                 prtMesh.faceCounts(), prtMesh.faceCountsCount());
+	isb.setGeometry(prtMesh.vertexCoords(), prtMesh.vcCount(), prtMesh.indices(), prtMesh.indicesCount(),
+	                prtMesh.faceCounts(), prtMesh.faceCountsCount());
 
-	isb->setAttributes(ruleFile.c_str(), startRule.c_str(), seed, L"", &attributeMap, &resolveMap);
+	isb.setAttributes(ruleFile.c_str(), startRule.c_str(), seed, L"", &attributeMap, &resolveMap);
 
-	const InitialShapeUPtr shape(isb->createInitialShapeAndReset());
+	const InitialShapeUPtr shape(isb.createInitialShapeAndReset());
 	const InitialShapeNOPtrVector shapes = {shape.get()};
 
 	const std::vector<const wchar_t*> encIDs = {ENC_ID_ATTR_EVAL};
-	const AttributeMapUPtr attrEncOpts = prtu::createValidatedOptions(ENC_ID_ATTR_EVAL);
-	const AttributeMapNOPtrVector encOpts = {attrEncOpts.get()};
+	const AttributeMapNOPtrVector encOpts = {getAttrEvalEncoderOptions()};
 	assert(encIDs.size() == encOpts.size());
 
 	prt::generate(shapes.data(), shapes.size(), nullptr, encIDs.data(), encIDs.size(), encOpts.data(), &mayaCallbacks,
 	              &cache, nullptr);
 
-	return AttributeMapUPtr(mayaCallbacksAttributeBuilder->createAttributeMap());
+	return AttributeMapUPtr(amb->createAttributeMapAndReset());
 }
 
-bool getIsUserSet(const MFnDependencyNode& node, const MFnAttribute& attribute) {
-	MString userSetAttributeName = attribute.name() + ATTRIBUTE_USER_SET_SUFFIX;
-
-	MStatus attrStat;
-	MObject userSetAttributeObj = node.attribute(userSetAttributeName, &attrStat);
-	if (attrStat == MS::kSuccess) {
-		const MPlug plug(node.object(), userSetAttributeObj);
-		bool isUserSet = plug.asBool(&attrStat);
-		MCHECK(attrStat);
-		return isUserSet;
-	}
-	return false;
-}
+struct EncoderOptions {
+	AttributeMapUPtr maya;
+	AttributeMapUPtr cgaError;
+	AttributeMapUPtr cgaPrint;
+};
 
-MStatus setIsUserSet(const MFnDependencyNode& node, const MFnAttribute& attribute, bool value) {
-	MString userSetAttributeName = attribute.name() + ATTRIBUTE_USER_SET_SUFFIX;
+EncoderOptions createEncoderOptions(bool boundingBoxesOnly, bool emitMaterials, bool emitReports) {
+	EncoderOptions options;
+	AttributeMapBuilderUPtr optionsBuilder(prt::AttributeMapBuilder::create());
 
-	MStatus attrStat;
-	MObject userSetAttributeObj = node.attribute(userSetAttributeName, &attrStat);
-	if (attrStat == MS::kSuccess) {
-		MPlug plug(node.object(), userSetAttributeObj);
+	optionsBuilder->setBool(EO_BOUNDING_BOXES_ONLY, boundingBoxesOnly);
+	optionsBuilder->setBool(EO_EMIT_MATERIALS, emitMaterials);
+	optionsBuilder->setBool(EO_EMIT_ATTRIBUTES, false); // the node does not read back the final attribute values
+	optionsBuilder->setBool(EO_EMIT_REPORTS, emitReports); // stored in the mesh metadata, see ReportInfo.h
+	const AttributeMapUPtr mayaOptions(optionsBuilder->createAttributeMapAndReset());
+	options.maya = prtu::createValidatedOptions(ENC_ID_MAYA, mayaOptions.get());
 
-		MCHECK(plug.setBool(value));
-	}
-	return attrStat;
-}
+	optionsBuilder->setString(L"name", FILE_CGA_ERROR);
+	const AttributeMapUPtr errOptions(optionsBuilder->createAttributeMapAndReset());
+	options.cgaError = prtu::createValidatedOptions(ENC_ID_CGA_ERROR, errOptions.get());
 
-bool getAndResetForceDefault(const MFnDependencyNode& node, const MFnAttribute& attribute) {
-	MString userSetAttributeName = attribute.name() + ATTRIBUTE_FORCE_DEFAULT_SUFFIX;
+	optionsBuilder->setString(L"name", FILE_CGA_PRINT);
+	const AttributeMapUPtr printOptions(optionsBuilder->createAttributeMapAndReset());
+	options.cgaPrint = prtu::createValidatedOptions(ENC_ID_CGA_PRINT, printOptions.get());
 
-	MStatus attrStat;
-	MObject userSetAttributeObj = node.attribute(userSetAttributeName, &attrStat);
-	if (attrStat == MS::kSuccess) {
-		MPlug plug(node.object(), userSetAttributeObj);
-		bool isUserSet = plug.asBool(&attrStat);
-		MCHECK(attrStat);
-		MCHECK(plug.setBool(false));
-		return isUserSet;
-	}
-	return false;
+	return options;
 }
 
-std::wstring removeSuffix(std::wstring const& fullString) {
-	for (const std::wstring suffix : {ATTRIBUTE_USER_SET_SUFFIX, ATTRIBUTE_FORCE_DEFAULT_SUFFIX}) {
-		if ((fullString.length() >= suffix.length()) &&
-		    (fullString.compare(fullString.length() - suffix.length(), suffix.length(), suffix) == 0))
-			return fullString.substr(0, fullString.length() - suffix.length());
-	}
-	return fullString;
+// the options do not depend on the node, so all (also the asynchronous) generate calls share them
+const EncoderOptions& getEncoderOptions(bool boundingBoxesOnly, bool emitMaterials, bool emitReports) {
+	static const std::array<EncoderOptions, 8> encoderOptions = {
+	        createEncoderOptions(false, false, false), createEncoderOptions(true, false, false),
+	        createEncoderOptions(false, true, false),  createEncoderOptions(true, true, false),
+	        createEncoderOptions(false, false, true),  createEncoderOptions(true, false, true),
+	        createEncoderOptions(false, true, true),   createEncoderOptions(true, true, true)};
+	return encoderOptions[(boundingBoxesOnly ? 1 : 0) + (emitMaterials ? 2 : 0) + (emitReports ? 4 : 0)];
 }
 
-enum class PrtAttributeType { BOOL, FLOAT, COLOR, STRING, ENUM };
-
-std::list<MObject> getNodeAttributesCorrespondingToCGA(const MFnDependencyNode& node) {
-	std::list<MObject> rawAttrs;
-	std::list<MObject> ignoreList;
+const EncoderOptions& getEncoderOptions(const GenerateJob& job) {
+	return getEncoderOptions(job.levelOfDetail == LevelOfDetail::BOUNDING_BOXES, job.emitMaterials,
+	                         job.emitReports);
+}
 
-	for (unsigned int i = 0, numAttrs = node.attributeCount(); i < numAttrs; i++) {
-		MStatus attrStat;
-		const MObject attrObj = node.attribute(i, &attrStat);
-		if (attrStat != MS::kSuccess)
-			continue;
+MStatus copyMeshData(const MObject& source, MObject& target) {
+	MStatus status;
+	MFnMesh sourceMesh(source, &status);
+	MCHECK(status);
 
-		const MFnAttribute attr(attrObj);
+	MFnMesh targetMesh(target, &status);
+	MCHECK(status);
+	MCHECK(targetMesh.copyInPlace(source));
+	MCHECK(targetMesh.setMetadata(sourceMesh.metadata()));
+	return status;
+}
 
-		// CGA rule attributes are maya dynamic attributes and not hidden
-		if (!attr.isDynamic() || attr.isHidden())
-			continue;
+// returns a copy of the mesh in new mesh data which is not owned by any data block
+MObject createDetachedMeshData(const MObject& mesh, MStatus& status) {
+	MFnMeshData dataCreator;
+	MObject meshData = dataCreator.create(&status);
+	if (status == MS::kSuccess)
+		MFnMesh().copy(mesh, meshData, &status);
+	return meshData;
+}
 
-		// maya annoyance: color attributes automatically get per-component plugs/child attrs
-		if (attr.isUsedAsColor()) {
-			MFnCompoundAttribute compAttr(attrObj);
-			for (unsigned int ci = 0, numChildren = compAttr.numChildren(); ci < numChildren; ci++)
-				ignoreList.emplace_back(compAttr.child(ci));
-		}
+// reads attribute values through the data block of the running compute, or through plugs outside of compute
+class AttributeValueReader {
+public:
+	AttributeValueReader(const MObject& node, MDataBlock* data) : mNode(node), mData(data) {}
 
-		rawAttrs.push_back(attrObj);
+	bool asBool(const MObject& attribute) const {
+		if (attribute.isNull())
+			return false;
+		return (mData != nullptr) ? mData->inputValue(attribute).asBool() : MPlug(mNode, attribute).asBool();
 	}
 
-	const auto isIgnored = [&ignoreList](const auto& attr) {
-		return std::find(ignoreList.begin(), ignoreList.end(), attr) != ignoreList.end();
-	};
-	rawAttrs.erase(std::remove_if(rawAttrs.begin(), rawAttrs.end(), isIgnored), rawAttrs.end());
+	double asDouble(const MObject& attribute) const {
+		return (mData != nullptr) ? mData->inputValue(attribute).asDouble() : MPlug(mNode, attribute).asDouble();
+	}
 
-	return rawAttrs;
-}
+	short asShort(const MObject& attribute) const {
+		return (mData != nullptr) ? mData->inputValue(attribute).asShort() : MPlug(mNode, attribute).asShort();
+	}
 
-template <typename T>
-MStatus iterateThroughAttributesAndApply(const MObject& node, const RuleAttributeMap& ruleAttributes, T attrFunction) {
-	MStatus stat;
-	const MFnDependencyNode fNode(node, &stat);
-	MCHECK(stat);
+	MString asString(const MObject& attribute) const {
+		return (mData != nullptr) ? mData->inputValue(attribute).asString() : MPlug(mNode, attribute).asString();
+	}
 
-	const std::list<MObject> cgaAttributes = getNodeAttributesCorrespondingToCGA(fNode);
+	prtu::Color asColor(const MObject& attribute) const {
+		prtu::Color col;
+		if (mData != nullptr) {
+			const float3& rgb = mData->inputValue(attribute).asFloat3();
+			col = {rgb[0], rgb[1], rgb[2]};
+		}
+		else {
+			MObject rgb;
+			MCHECK(MPlug(mNode, attribute).getValue(rgb));
+			MFnNumericData fRGB(rgb);
+			MCHECK(fRGB.getData3Float(col[0], col[1], col[2]));
+		}
+		return col;
+	}
 
-	for (const auto& attrObj : cgaAttributes) {
-		MFnAttribute fnAttr(attrObj);
+private:
+	const MObject& mNode;
+	MDataBlock* mData;
+};
 
-		const MString fullAttrName = fnAttr.name();
-		auto ruleAttrIt = ruleAttributes.find(fullAttrName.asWChar());
-		assert(ruleAttrIt != ruleAttributes.end()); // Rule not found
-		const RuleAttribute ruleAttr = (ruleAttrIt != ruleAttributes.end()) ? ruleAttrIt->second : RuleAttribute();
+bool getIsUserSet(const MFnDependencyNode& node, const NodeRuleAttribute& attribute) {
+	return AttributeValueReader(node.object(), nullptr).asBool(attribute.userSetAttribute);
+}
 
-		[[maybe_unused]] const auto ruleAttrType = ruleAttr.mType;
+MStatus setIsUserSet(const MFnDependencyNode& node, const NodeRuleAttribute& attribute, bool value) {
+	if (attribute.userSetAttribute.isNull())
+		return MS::kFailure;
 
-		if (attrObj.hasFn(MFn::kNumericAttribute)) {
-			MFnNumericAttribute nAttr(attrObj);
+	MPlug plug(node.object(), attribute.userSetAttribute);
+	MCHECK(plug.setBool(value));
+	return MS::kSuccess;
+}
 
-			if (nAttr.unitType() == MFnNumericData::kBoolean) {
-				assert(ruleAttrType == prt::AAT_BOOL);
+bool getAndResetForceDefault(const MFnDependencyNode& node, const NodeRuleAttribute& attribute) {
+	if (attribute.forceDefaultAttribute.isNull())
+		return false;
 
-				attrFunction(fNode, fnAttr, ruleAttr, PrtAttributeType::BOOL);
-			}
-			else if (nAttr.unitType() == MFnNumericData::kDouble) {
-				assert(ruleAttrType == prt::AAT_FLOAT);
+	MStatus attrStat;
+	MPlug plug(node.object(), attribute.forceDefaultAttribute);
+	bool isForceDefault = plug.asBool(&attrStat);
+	MCHECK(attrStat);
+	MCHECK(plug.setBool(false));
+	return isForceDefault;
+}
 
-				attrFunction(fNode, fnAttr, ruleAttr, PrtAttributeType::FLOAT);
-			}
-			else if (nAttr.isUsedAsColor()) {
-				assert(ruleAttrType == prt::AAT_STR);
+std::wstring removeSuffix(std::wstring const& fullString) {
+	for (const std::wstring suffix : {ATTRIBUTE_USER_SET_SUFFIX, ATTRIBUTE_FORCE_DEFAULT_SUFFIX}) {
+		if ((fullString.length() >= suffix.length()) &&
+		    (fullString.compare(fullString.length() - suffix.length(), suffix.length(), suffix) == 0))
+			return fullString.substr(0, fullString.length() - suffix.length());
+	}
+	return fullString;
+}
 
-				attrFunction(fNode, fnAttr, ruleAttr, PrtAttributeType::COLOR);
-			}
-		}
-		else if (attrObj.hasFn(MFn::kTypedAttribute)) {
-			assert(ruleAttrType == prt::AAT_STR);
+template <typename T>
+MStatus iterateThroughAttributesAndApply(const MObject& node, const std::vector<NodeRuleAttribute>& nodeAttributes,
+                                         T attrFunction) {
+	MStatus stat;
+	const MFnDependencyNode fNode(node, &stat);
+	MCHECK(stat);
 
-			attrFunction(fNode, fnAttr, ruleAttr, PrtAttributeType::STRING);
-		}
-		else if (attrObj.hasFn(MFn::kEnumAttribute)) {
-			attrFunction(fNode, fnAttr, ruleAttr, PrtAttributeType::ENUM);
-		}
+	for (const NodeRuleAttribute& nodeAttribute : nodeAttributes) {
+		const MFnAttribute fnAttr(nodeAttribute.attribute);
+		attrFunction(fNode, fnAttr, nodeAttribute);
 	}
 	return MStatus::kSuccess;
 }
@@ -395,69 +427,52 @@ T getPlugValueAndRemoveAttr(MFnDependencyNode& node, const MString& briefName, c
 
 	return plugValue;
 }
-} // namespace
 
-PRTModifierAction::PRTModifierAction() {
-	AttributeMapBuilderUPtr optionsBuilder(prt::AttributeMapBuilder::create());
+void addToDigest(prtu::Fnv1aHash& digest, const std::wstring& str) {
+	digest.add(str.size());
+	digest.add(str.data(), str.size() * sizeof(wchar_t));
+}
 
-	mMayaEncOpts = prtu::createValidatedOptions(ENC_ID_MAYA);
+// only call on the main thread, generate() also runs on the background thread of the GenerateScheduler
+void displayGenerateError(prt::Status generateStatus) {
+	std::string generateFailedMessage = "prt generate failed: ";
+	generateFailedMessage.append(prt::getStatusDescription(generateStatus));
+	MGlobal::displayError(generateFailedMessage.c_str());
+}
+} // namespace
 
-	optionsBuilder->setString(L"name", FILE_CGA_ERROR);
-	const AttributeMapUPtr errOptions(optionsBuilder->createAttributeMapAndReset());
-	mCGAErrorOptions = prtu::createValidatedOptions(ENC_ID_CGA_ERROR, errOptions.get());
+PRTModifierAction::PRTModifierAction()
+    : mInitialShapeBuilder(prt::InitialShapeBuilder::create()),
+      mAttributeMapBuilder(prt::AttributeMapBuilder::create()) {}
 
-	optionsBuilder->setString(L"name", FILE_CGA_PRINT);
-	const AttributeMapUPtr printOptions(optionsBuilder->createAttributeMapAndReset());
-	mCGAPrintOptions = prtu::createValidatedOptions(ENC_ID_CGA_PRINT, printOptions.get());
-}
+MStatus PRTModifierAction::fillAttributesFromNode(const MObject& node, MDataBlock* data) {
+	const AttributeValueReader reader(node, data);
 
-MStatus PRTModifierAction::fillAttributesFromNode(const MObject& node) {
-	AttributeMapBuilderSPtr aBuilder(prt::AttributeMapBuilder::create(), PRTDestroyer());
+	const auto readUserValue = [this, &reader](const NodeRuleAttribute& nodeAttribute) {
+		std::optional<RuleAttributeValue> userValue;
 
-	const auto fillAttributeFromNode = [this, aBuilder](const MFnDependencyNode& fnNode,
-	                                                    const MFnAttribute& fnAttribute,
-	                                                    const RuleAttribute& ruleAttribute,
-	                                                    const PrtAttributeType attrType) mutable {
-		MPlug plug(fnNode.object(), fnAttribute.object());
-		const std::wstring fqAttrName = ruleAttribute.fqName;
+		// only user set values are passed to the rule, the others are evaluated by the rule itself
+		if (!reader.asBool(nodeAttribute.userSetAttribute))
+			return userValue;
+
+		const RuleAttribute& ruleAttribute = nodeAttribute.ruleAttribute;
 		const prt::AnnotationArgumentType ruleAttrType = ruleAttribute.mType;
 
-		switch (attrType) {
+		switch (nodeAttribute.type) {
 			case PrtAttributeType::BOOL: {
-				bool boolVal;
-				MCHECK(plug.getValue(boolVal));
-
-				if (getIsUserSet(fnNode, fnAttribute))
-					aBuilder->setBool(fqAttrName.c_str(), boolVal);
+				userValue = reader.asBool(nodeAttribute.attribute);
 				break;
 			}
 			case PrtAttributeType::FLOAT: {
-				double doubleVal;
-				MCHECK(plug.getValue(doubleVal));
-
-				if (getIsUserSet(fnNode, fnAttribute))
-					aBuilder->setFloat(fqAttrName.c_str(), doubleVal);
+				userValue = reader.asDouble(nodeAttribute.attribute);
 				break;
 			}
 			case PrtAttributeType::COLOR: {
-				MObject rgb;
-				MCHECK(plug.getValue(rgb));
-				MFnNumericData fRGB(rgb);
-
-				prtu::Color col;
-				MCHECK(fRGB.getData3Float(col[0], col[1], col[2]));
-				const std::wstring colStr = prtu::getColorString(col);
-
-				if (getIsUserSet(fnNode, fnAttribute))
-					aBuilder->setString(fqAttrName.c_str(), colStr.c_str());
+				userValue = prtu::getColorString(reader.asColor(nodeAttribute.attribute));
 				break;
 			}
 			case PrtAttributeType::STRING: {
-				MString stringVal;
-				MCHECK(plug.getValue(stringVal));
-
-				if (getIsUserSet(fnNode, fnAttribute))
-					aBuilder->setString(fqAttrName.c_str(), stringVal.asWChar());
+				userValue = std::wstring(reader.asString(nodeAttribute.attribute).asWChar());
 				break;
 			}
 			case PrtAttributeType::ENUM: {
@@ -466,23 +481,20 @@ MStatus PRTModifierAction::fillAttributesFromNode(const MObject& node) {
 					break;
 				const PRTModifierEnum& currEnum = it->second;
 
-				short enumVal;
-				MCHECK(plug.getValue(enumVal));
-
-				if (getIsUserSet(fnNode, fnAttribute)) {
-					switch (ruleAttrType) {
-						case prt::AAT_STR:
-							aBuilder->setString(fqAttrName.c_str(), currEnum.getOptionName(enumVal).asWChar());
-							break;
-						case prt::AAT_FLOAT:
-							aBuilder->setFloat(fqAttrName.c_str(), currEnum.getOptionName(enumVal).asDouble());
-							break;
-						case prt::AAT_BOOL:
-							aBuilder->setBool(fqAttrName.c_str(), currEnum.getOptionName(enumVal).asInt() != 0);
-							break;
-						default:
-							LOG_ERR << "Cannot handle attribute type " << ruleAttrType << " for attr " << fqAttrName;
-					}
+				const MString optionName = currEnum.getOptionName(reader.asShort(nodeAttribute.attribute));
+				switch (ruleAttrType) {
+					case prt::AAT_STR:
+						userValue = std::wstring(optionName.asWChar());
+						break;
+					case prt::AAT_FLOAT:
+						userValue = optionName.asDouble();
+						break;
+					case prt::AAT_BOOL:
+						userValue = (optionName.asInt() != 0);
+						break;
+					default:
+						LOG_ERR << "Cannot handle attribute type " << ruleAttrType << " for attr "
+						        << ruleAttribute.fqName;
 				}
 				break;
 			}
@@ -490,23 +502,102 @@ MStatus PRTModifierAction::fillAttributesFromNode(const MObject& node) {
 			default:
 				break;
 		}
+		return userValue;
 	};
 
-	iterateThroughAttributesAndApply(node, mRuleAttributes, fillAttributeFromNode);
-	mGenerateAttrs.reset(aBuilder->createAttributeMap());
+	bool userValuesChanged = mGenerateAttrsDirty || !mGenerateAttrs;
+	for (NodeRuleAttribute& nodeAttribute : mNodeRuleAttributes) {
+		if (!nodeAttribute.dirty)
+			continue;
+
+		std::optional<RuleAttributeValue> userValue = readUserValue(nodeAttribute);
+		if (userValue != nodeAttribute.userValue) {
+			nodeAttribute.userValue = std::move(userValue);
+			userValuesChanged = true;
+		}
+
+		// outside of compute the flags are kept for the user set detection in the next compute
+		if (data != nullptr)
+			nodeAttribute.dirty = false;
+	}
+
+	if (!userValuesChanged)
+		return MStatus::kSuccess;
+
+	// the digest covers the same typed values as the attribute map, see getGenerateDigest()
+	AttributeMapBuilderUPtr& aBuilder = mAttributeMapBuilder;
+	prtu::Fnv1aHash attrsDigest;
+	for (const NodeRuleAttribute& nodeAttribute : mNodeRuleAttributes) {
+		if (!nodeAttribute.userValue)
+			continue;
+
+		const RuleAttributeValue& userValue = *nodeAttribute.userValue;
+		const std::wstring& fqAttrName = nodeAttribute.ruleAttribute.fqName;
+		addToDigest(attrsDigest, fqAttrName);
+		attrsDigest.add(userValue.index());
+		if (const bool* boolVal = std::get_if<bool>(&userValue)) {
+			aBuilder->setBool(fqAttrName.c_str(), *boolVal);
+			attrsDigest.add(*boolVal);
+		}
+		else if (const double* doubleVal = std::get_if<double>(&userValue)) {
+			aBuilder->setFloat(fqAttrName.c_str(), *doubleVal);
+			attrsDigest.add(*doubleVal);
+		}
+		else {
+			const std::wstring& stringVal = std::get<std::wstring>(userValue);
+			aBuilder->setString(fqAttrName.c_str(), stringVal.c_str());
+			addToDigest(attrsDigest, stringVal);
+		}
+	}
+
+	if (mLevelOfDetail != LevelOfDetail::FULL) {
+		const std::wstring lodFqName = mRuleStyle + L"$" + RULE_ATTRIBUTE_LOD;
+		for (const auto& [mayaName, ruleAttr] : mRuleAttributes) {
+			if ((ruleAttr.fqName == lodFqName) && (ruleAttr.mType == prt::AAT_FLOAT)) {
+				aBuilder->setFloat(lodFqName.c_str(), 0.0);
+				addToDigest(attrsDigest, lodFqName);
+			}
+		}
+	}
+
+	mGenerateAttrs.reset(aBuilder->createAttributeMapAndReset(), PRTDestroyer());
+	mGenerateAttrsDigest = attrsDigest.value();
+	mGenerateAttrsDirty = false;
 
 	return MStatus::kSuccess;
 }
 
+void PRTModifierAction::setAttributeDirty(const MPlug& plug) {
+	// color attributes are dirtied through their per-component child plugs
+	const MPlug attributePlug = plug.isChild() ? plug.parent() : plug;
+	const MFnAttribute fnAttr(attributePlug.attribute());
+
+	const auto it = mNodeRuleAttributeIndices.find(fnAttr.name().asWChar());
+	if (it != mNodeRuleAttributeIndices.end())
+		mNodeRuleAttributes[it->second].dirty = true;
+}
+
 MStatus PRTModifierAction::updateUserSetAttributes(const MObject& node) {
-	const auto updateUserSetAttribute = [this](const MFnDependencyNode& fnNode, const MFnAttribute& fnAttribute,
-	                                           const RuleAttribute& ruleAttribute, const PrtAttributeType attrType) {
-		const AttributeMapUPtr defaultAttributeValues =
-		        getDefaultAttributeValues(mRuleFile, mStartRule, *getResolveMap(), *PRTContext::get().mPRTCache,
-		                                  *inPrtMesh, mRandomSeed, *mGenerateAttrs);
-
-		if (getAndResetForceDefault(fnNode, fnAttribute)) {
-			setIsUserSet(fnNode, fnAttribute, false);
+	// only attributes changed since the last compute can have been set by the user
+	const auto isDirty = [](const NodeRuleAttribute& nodeAttribute) { return nodeAttribute.dirty; };
+	if (std::none_of(mNodeRuleAttributes.begin(), mNodeRuleAttributes.end(), isDirty))
+		return MStatus::kSuccess;
+
+	const AttributeMapUPtr defaultAttributeValues =
+	        getDefaultAttributeValues(mRuleFile, mStartRule, *getResolveMap(), *PRTContext::get().mPRTCache,
+	                                  *inPrtMesh, mRandomSeed, *mGenerateAttrs, *mInitialShapeBuilder,
+	                                  mAttributeMapBuilder);
+
+	const auto updateUserSetAttribute = [this, &defaultAttributeValues](const MFnDependencyNode& fnNode,
+	                                                                    const MFnAttribute& fnAttribute,
+	                                                                    const NodeRuleAttribute& nodeAttribute) {
+		if (!nodeAttribute.dirty)
+			return;
+
+		const RuleAttribute& ruleAttribute = nodeAttribute.ruleAttribute;
+
+		if (getAndResetForceDefault(fnNode, nodeAttribute)) {
+			setIsUserSet(fnNode, nodeAttribute, false);
 			return;
 		}
 
@@ -514,7 +605,7 @@ MStatus PRTModifierAction::updateUserSetAttributes(const MObject& node) {
 		bool isDefaultValue = false;
 		const std::wstring fqAttrName = ruleAttribute.fqName;
 
-		switch (attrType) {
+		switch (nodeAttribute.type) {
 			case PrtAttributeType::BOOL: {
 				const bool defBoolVal = defaultAttributeValues->getBool(fqAttrName.c_str());
 				bool boolVal;
@@ -574,25 +665,39 @@ MStatus PRTModifierAction::updateUserSetAttributes(const MObject& node) {
 		}
 
 		if (!isDefaultValue)
-			setIsUserSet(fnNode, fnAttribute, true);
+			setIsUserSet(fnNode, nodeAttribute, true);
 	};
 
-	iterateThroughAttributesAndApply(node, mRuleAttributes, updateUserSetAttribute);
+	iterateThroughAttributesAndApply(node, mNodeRuleAttributes, updateUserSetAttribute);
 
 	return MStatus::kSuccess;
 }
 
 MStatus PRTModifierAction::updateUI(const MObject& node, MObject& cgacProblemObject) {
-	const auto updateUIFromAttributes = [this, node](const MFnDependencyNode& fnNode, const MFnAttribute& fnAttribute,
-	                                                 const RuleAttribute& ruleAttribute,
-	                                                 const PrtAttributeType attrType) {
-		const AttributeMapUPtr defaultAttributeValues =
-		        getDefaultAttributeValues(mRuleFile, mStartRule, *getResolveMap(), *PRTContext::get().mPRTCache,
-		                                  *inPrtMesh, mRandomSeed, *mGenerateAttrs);
+	MPlug cgacProblemPlug(node, cgacProblemObject);
+	updateCgacProblemData(cgacProblemPlug, mCGACProblems);
+
+	// the defaults (and dynamic enum options) only depend on the generate inputs, skip re-evaluating them if those
+	// did not change since the last pass
+	const uint64_t uiDigest = getGenerateDigest();
+	if (mUIDigest == uiDigest)
+		return MStatus::kSuccess;
+	mUIDigest = uiDigest;
+
+	const AttributeMapUPtr defaultAttributeValues =
+	        getDefaultAttributeValues(mRuleFile, mStartRule, *getResolveMap(), *PRTContext::get().mPRTCache,
+	                                  *inPrtMesh, mRandomSeed, *mGenerateAttrs, *mInitialShapeBuilder,
+	                                  mAttributeMapBuilder);
+
+	const auto updateUIFromAttributes = [this, node, &defaultAttributeValues](const MFnDependencyNode& fnNode,
+	                                                                          const MFnAttribute& fnAttribute,
+	                                                                          const NodeRuleAttribute& nodeAttribute) {
+		const RuleAttribute& ruleAttribute = nodeAttribute.ruleAttribute;
+
 		MPlug plug(fnNode.object(), fnAttribute.object());
 		const std::wstring fqAttrName = ruleAttribute.fqName;
 
-		switch (attrType) {
+		switch (nodeAttribute.type) {
 			case PrtAttributeType::BOOL: {
 				const bool defBoolVal = defaultAttributeValues->getBool(fqAttrName.c_str());
 				bool boolVal;
@@ -600,7 +705,7 @@ MStatus PRTModifierAction::updateUI(const MObject& node, MObject& cgacProblemObj
 
 				const bool isDefaultValue = (defBoolVal == boolVal);
 
-				if (!getIsUserSet(fnNode, fnAttribute) && !isDefaultValue)
+				if (!getIsUserSet(fnNode, nodeAttribute) && !isDefaultValue)
 					plug.setBool(defBoolVal);
 				break;
 			}
@@ -611,7 +716,7 @@ MStatus PRTModifierAction::updateUI(const MObject& node, MObject& cgacProblemObj
 
 				const bool isDefaultValue = (defDoubleVal == doubleVal);
 
-				if (!getIsUserSet(fnNode, fnAttribute) && !isDefaultValue)
+				if (!getIsUserSet(fnNode, nodeAttribute) && !isDefaultValue)
 					plug.setDouble(defDoubleVal);
 				break;
 			}
@@ -633,7 +738,7 @@ MStatus PRTModifierAction::updateUI(const MObject& node, MObject& cgacProblemObj
 
 				const bool isDefaultValue = (std::wcscmp(colStr.c_str(), defColStr) == 0);
 
-				if (!getIsUserSet(fnNode, fnAttribute) && !isDefaultValue)
+				if (!getIsUserSet(fnNode, nodeAttribute) && !isDefaultValue)
 					plug.setMObject(defaultColorObj);
 				break;
 			}
@@ -647,7 +752,7 @@ MStatus PRTModifierAction::updateUI(const MObject& node, MObject& cgacProblemObj
 
 				const bool isDefaultValue = (std::wcscmp(stringVal.asWChar(), defStringVal) == 0);
 
-				if (!getIsUserSet(fnNode, fnAttribute) && !isDefaultValue)
+				if (!getIsUserSet(fnNode, nodeAttribute) && !isDefaultValue)
 					plug.setString(defStringVal);
 				break;
 			}
@@ -669,7 +774,7 @@ MStatus PRTModifierAction::updateUI(const MObject& node, MObject& cgacProblemObj
 				const bool isDefaultValue = (defEnumVal == enumVal);
 				const bool hasNewValue = (enumVal != newEnumVal);
 
-				if ((!getIsUserSet(fnNode, fnAttribute) && !isDefaultValue))
+				if ((!getIsUserSet(fnNode, nodeAttribute) && !isDefaultValue))
 					plug.setShort(defEnumVal);
 				else if (hasNewValue)
 					plug.setShort(newEnumVal);
@@ -682,29 +787,73 @@ MStatus PRTModifierAction::updateUI(const MObject& node, MObject& cgacProblemObj
 		}
 	};
 
-	MPlug cgacProblemPlug(node, cgacProblemObject);
-	updateCgacProblemData(cgacProblemPlug, mCGACProblems);
-	iterateThroughAttributesAndApply(node, mRuleAttributes, updateUIFromAttributes);
+	iterateThroughAttributesAndApply(node, mNodeRuleAttributes, updateUIFromAttributes);
 
 	return MStatus::kSuccess;
 }
 
 // Sets the mesh object for the action  to operate on
-void PRTModifierAction::setMesh(MObject& _inMesh, MObject& _outMesh) {
+void PRTModifierAction::setMesh(MObject& _inMesh, MObject& _outMesh, bool inMeshChanged, bool keepsGeneratedOutMesh) {
 	inMesh = _inMesh;
 	outMesh = _outMesh;
+	if (!keepsGeneratedOutMesh)
+		mOutMeshTopology.reset();
 
-	inPrtMesh = std::make_unique<PRTMesh>(_inMesh);
+	if (inMeshChanged || !inPrtMesh)
+		inPrtMesh = std::make_shared<const PRTMesh>(_inMesh);
 }
 
-ResolveMapSPtr PRTModifierAction::getResolveMap() {
+ResolveMapSPtr PRTModifierAction::getResolveMap() const {
 	ResolveMapCache::LookupResult lookupResult =
 	        PRTContext::get().mResolveMapCache->get(std::wstring(mRulePkg.asWChar()));
 	ResolveMapSPtr resolveMap = lookupResult.first;
 	return resolveMap;
 }
 
+MStatus PRTModifierAction::loadRulePackage(const MString& rulePkg, RulePackageInfo& rulePackageInfo) {
+	const auto fail = [&rulePkg, &rulePackageInfo](const char* message) -> MStatus {
+		rulePackageInfo.ruleFileInfo.reset();
+		rulePackageInfo.problems = createCGACErrorFromString(MString(message) + rulePkg.asWChar());
+		return MS::kFailure;
+	};
+
+	std::filesystem::path rulePkgPath(rulePkg.asWChar());
+	if (!std::filesystem::exists(rulePkgPath))
+		return fail("could not find rule package ");
+
+	rulePackageInfo.resolveMap = PRTContext::get().mResolveMapCache->get(std::wstring(rulePkg.asWChar())).first;
+	if (!rulePackageInfo.resolveMap)
+		return fail("failed to get resolve map from rule package ");
+
+	rulePackageInfo.ruleFile = prtu::getRuleFileEntry(rulePackageInfo.resolveMap);
+	if (rulePackageInfo.ruleFile.empty())
+		return fail("could not find rule file in rule package ");
+
+	prt::Status infoStatus = prt::STATUS_UNSPECIFIED_ERROR;
+	const wchar_t* ruleFileURI = rulePackageInfo.resolveMap->getString(rulePackageInfo.ruleFile.c_str());
+	if (ruleFileURI == nullptr)
+		return fail("could not find rule file URI in resolve map of rule package ");
+
+	rulePackageInfo.ruleFileInfo.reset(
+	        prt::createRuleFileInfo(ruleFileURI, PRTContext::get().mPRTCache.get(), &infoStatus));
+	if (!rulePackageInfo.ruleFileInfo || infoStatus != prt::STATUS_OK)
+		return fail("could not get rule file info from rule file ");
+
+	rulePackageInfo.startRule = prtu::detectStartRule(rulePackageInfo.ruleFileInfo);
+	return MS::kSuccess;
+}
+
 MStatus PRTModifierAction::updateRuleFiles(const MObject& node, const MString& rulePkg, MObject& cgacProblemObject) {
+	PRTContext::get().mPRTCache.get()->flushAll();
+
+	RulePackageInfo rulePackageInfo;
+	loadRulePackage(rulePkg, rulePackageInfo);
+	return updateRuleFiles(node, rulePkg, rulePackageInfo, cgacProblemObject);
+}
+
+MStatus PRTModifierAction::updateRuleFiles(const MObject& node, const MString& rulePkg,
+                                           const RulePackageInfo& rulePackageInfo, MObject& cgacProblemObject,
+                                           AttributeMapUPtr defaultAttributeValues) {
 	MPlug cgacProblemPlug(node, cgacProblemObject);
 
 	mRulePkg = rulePkg;
@@ -713,63 +862,34 @@ MStatus PRTModifierAction::updateRuleFiles(const MObject& node, const MString& r
 	mRuleFile.clear();
 	mStartRule.clear();
 	mRuleAttributes.clear();
-	PRTContext::get().mPRTCache.get()->flushAll();
-
-	std::filesystem::path rulePkgPath(mRulePkg.asWChar());
-	if (!std::filesystem::exists(rulePkgPath)) {
-		CGACErrors cgacProblems =
-		        createCGACErrorFromString(MString("could not find rule package ") + mRulePkg.asWChar());
-		updateCgacProblemData(cgacProblemPlug, cgacProblems);
-		return MS::kFailure;
-	}
-
-	ResolveMapSPtr resolveMap = getResolveMap();
-	if (!resolveMap) {
-		CGACErrors cgacProblems =
-		        createCGACErrorFromString(MString("failed to get resolve map from rule package ") + mRulePkg.asWChar());
-		updateCgacProblemData(cgacProblemPlug, cgacProblems);
-		return MS::kFailure;
-	}
 
-	mRuleFile = prtu::getRuleFileEntry(resolveMap);
-	if (mRuleFile.empty()) {
-		CGACErrors cgacProblems =
-		        createCGACErrorFromString(MString("could not find rule file in rule package ") + mRulePkg.asWChar());
-		updateCgacProblemData(cgacProblemPlug, cgacProblems);
+	if (!rulePackageInfo.ruleFileInfo) {
+		updateCgacProblemData(cgacProblemPlug, rulePackageInfo.problems);
 		return MS::kFailure;
 	}
 
-	prt::Status infoStatus = prt::STATUS_UNSPECIFIED_ERROR;
-	const wchar_t* ruleFileURI = resolveMap->getString(mRuleFile.c_str());
-	if (ruleFileURI == nullptr) {
-		CGACErrors cgacProblems = createCGACErrorFromString(
-		        MString("could not find rule file URI in resolve map of rule package ") + mRulePkg.asWChar());
-		updateCgacProblemData(cgacProblemPlug, cgacProblems);
-		return MS::kFailure;
-	}
-
-	RuleFileInfoUPtr info(prt::createRuleFileInfo(ruleFileURI, PRTContext::get().mPRTCache.get(), &infoStatus));
-	if (!info || infoStatus != prt::STATUS_OK) {
-		CGACErrors cgacProblems =
-		        createCGACErrorFromString(MString("could not get rule file info from rule file ") + mRulePkg.asWChar());
-		updateCgacProblemData(cgacProblemPlug, cgacProblems);
-		return MS::kFailure;
-	}
-
-	mStartRule = prtu::detectStartRule(info);
-	mGenerateAttrs = getDefaultAttributeValues(mRuleFile, mStartRule, *getResolveMap(), *PRTContext::get().mPRTCache,
-	                                           *inPrtMesh, mRandomSeed, *EMPTY_ATTRIBUTES);
+	mRuleFile = rulePackageInfo.ruleFile;
+	mStartRule = rulePackageInfo.startRule;
+	if (defaultAttributeValues)
+		mGenerateAttrs = std::move(defaultAttributeValues);
+	else
+		mGenerateAttrs = getDefaultAttributeValues(mRuleFile, mStartRule, *rulePackageInfo.resolveMap,
+		                                           *PRTContext::get().mPRTCache, *inPrtMesh, mRandomSeed,
+		                                           *EMPTY_ATTRIBUTES, *mInitialShapeBuilder, mAttributeMapBuilder);
+	mGenerateAttrsDigest = 0; // the defaults only depend on inputs the generate digest already covers
 	if (DBG)
-		LOG_DBG << "default attrs: " << prtu::objectToXML(mGenerateAttrs);
+		LOG_DBG << "default attrs: " << prtu::objectToXML(mGenerateAttrs.get());
 
 	if (node != MObject::kNullObj) {
+		const prt::RuleFileInfo* info = rulePackageInfo.ruleFileInfo.get();
+
 		// derive necessary data from PRT rule info to populate node with dynamic rule attributes
-		RuleAttributeSet ruleAttributes = getRuleAttributes(mRuleFile, info.get());
+		RuleAttributeSet ruleAttributes = getRuleAttributes(mRuleFile, info);
 		for (const RuleAttribute& ruleAttr : ruleAttributes) {
 			mRuleAttributes[ruleAttr.mayaFullName] = ruleAttr;
 		}
 
-		createNodeAttributes(ruleAttributes, node, info.get());
+		createNodeAttributes(ruleAttributes, node, info);
 		for (auto& enumPair : mEnums) {
 			enumPair.second.updateOptions(node, mRuleAttributes, *mGenerateAttrs);
 		}
@@ -779,43 +899,303 @@ MStatus PRTModifierAction::updateRuleFiles(const MObject& node, const MString& r
 }
 
 MStatus PRTModifierAction::doIt() {
-	MStatus status;
+	cancelAsyncJob();
+	mAsyncOutput = MObject::kNullObj;
 
-	AttributeMapBuilderUPtr amb(prt::AttributeMapBuilder::create());
-	std::unique_ptr<MayaCallbacks> outputHandler(new MayaCallbacks(inMesh, outMesh, amb));
+	if (mPrefetchedOutput && (mPrefetchedOutput->generateDigest == getGenerateDigest())) {
+		MCHECK(copyMeshData(mPrefetchedOutput->meshData, outMesh));
+
+		mCGACProblems = std::move(mPrefetchedOutput->cgacProblems);
+		mOutMeshTopology = mPrefetchedOutput->topology;
+		mPrefetchedOutput.reset();
+		return MS::kSuccess;
+	}
+	mPrefetchedOutput.reset();
+
+	return generate(std::vector<PRTModifierAction*>{this});
+}
+
+MStatus PRTModifierAction::doItAsync(const MObject& node) {
+	mPrefetchedOutput.reset();
+	mOutMeshTopology.reset(); // outMesh receives copies of the async results
+
+	// a finished job is the most recent result, even if the inputs changed in the meantime
+	if (mAsyncJob && mAsyncJob->done) {
+		mAsyncOutput = mAsyncJob->outMesh;
+		mCGACProblems = mAsyncJob->cgacProblems;
+
+		if ((mAsyncJob->generateStatus != prt::STATUS_OK) && !mAsyncJob->failureReported) {
+			displayGenerateError(mAsyncJob->generateStatus);
+			mAsyncJob->failureReported = true;
+		}
+	}
+
+	const uint64_t generateDigest = getGenerateDigest();
+	if (!mAsyncJob || (mAsyncJob->generateDigest != generateDigest)) {
+		cancelAsyncJob();
+
+		// the job outlives this compute, so it must not reference the data block of the node
+		MStatus status;
+		const MObject meshData = createDetachedMeshData(inMesh, status);
+		MCHECK(status);
+		if (status != MS::kSuccess)
+			return status;
+
+		auto job = std::make_shared<AsyncGenerateJob>();
+		fillGenerateJob(*job);
+		job->inMesh = meshData;
+		job->outMesh = meshData;
+		job->generateDigest = generateDigest;
+		job->nodeUuid = MFnDependencyNode(node).uuid().asString().asWChar();
+
+		mAsyncJob = job;
+		GenerateScheduler::get().generateAsync(std::move(job));
+	}
+
+	// outMesh already holds the input mesh, which serves as proxy until the first job is done
+	if (mAsyncOutput.isNull())
+		return MS::kSuccess;
+
+	return copyMeshData(mAsyncOutput, outMesh);
+}
+
+void PRTModifierAction::cancelAsyncJob() {
+	if (mAsyncJob && !mAsyncJob->done)
+		mAsyncJob->superseded = true;
+	mAsyncJob.reset();
+}
+
+void PRTModifierAction::fillGenerateJob(GenerateJob& job) const {
+	job.prtMesh = inPrtMesh;
+	job.resolveMap = getResolveMap();
+	job.ruleFile = mRuleFile;
+	job.startRule = mStartRule;
+	job.randomSeed = mRandomSeed;
+	job.levelOfDetail = mLevelOfDetail;
+	job.emitMaterials = mEmitMaterials;
+	job.emitReports = mEmitReports;
+	job.faceNormalsAsHardEdges = mFaceNormalsAsHardEdges;
+	job.generateAttrs = mGenerateAttrs;
+	job.inMesh = inMesh;
+	job.outMesh = outMesh;
+	job.outMeshTopology = mOutMeshTopology;
+}
+
+MStatus PRTModifierAction::generate(const std::vector<PRTModifierAction*>& actions) {
+	std::vector<GenerateJob> jobs(actions.size());
+	std::vector<GenerateJob*> jobPtrs;
+	jobPtrs.reserve(actions.size());
+	for (size_t i = 0; i < actions.size(); i++) {
+		actions[i]->fillGenerateJob(jobs[i]);
+		jobPtrs.push_back(&jobs[i]);
+	}
+
+	const MStatus status = generate(jobPtrs);
+
+	const auto failedJob = std::find_if(jobs.begin(), jobs.end(),
+	                                    [](const GenerateJob& job) { return job.generateStatus != prt::STATUS_OK; });
+	if (failedJob != jobs.end())
+		displayGenerateError(failedJob->generateStatus);
+
+	for (size_t i = 0; i < actions.size(); i++) {
+		PRTModifierAction& action = *actions[i];
+		action.mCGACProblems = std::move(jobs[i].cgacProblems);
+		action.mOutMeshTopology = jobs[i].outMeshTopology;
+
+		// without a generated mesh the output falls back to the input mesh, as if it had not been handed over
+		if (!action.mOutMeshTopology && (action.outMesh != action.inMesh))
+			MCHECK(copyMeshData(action.inMesh, action.outMesh));
+	}
+
+	return status;
+}
+
+MStatus PRTModifierAction::generate(const std::vector<GenerateJob*>& jobs) {
+	if (jobs.empty())
+		return MS::kSuccess;
+
+	// the encoder options apply to all initial shapes, jobs with other options need a generate call of their own
+	const EncoderOptions& options = getEncoderOptions(*jobs.front());
+	const auto hasSameOptions = [&options](const GenerateJob* job) { return &getEncoderOptions(*job) == &options; };
+	if (!std::all_of(jobs.begin(), jobs.end(), hasSameOptions)) {
+		std::vector<GenerateJob*> sameOptionJobs;
+		std::vector<GenerateJob*> otherJobs;
+		std::partition_copy(jobs.begin(), jobs.end(), std::back_inserter(sameOptionJobs),
+		                    std::back_inserter(otherJobs), hasSameOptions);
+
+		const MStatus sameOptionStatus = generate(sameOptionJobs);
+		const MStatus otherStatus = generate(otherJobs);
+		return (sameOptionStatus != MS::kSuccess) ? sameOptionStatus : otherStatus;
+	}
+
+	std::vector<MObject> inMeshes;
+	std::vector<MObject> outMeshes;
+	std::vector<const std::atomic<bool>*> cancelFlags;
+	std::vector<bool> faceNormalsAsHardEdges;
+	std::vector<std::optional<uint64_t>> outMeshTopologies;
+	std::vector<InitialShapeUPtr> initialShapes;
+	inMeshes.reserve(jobs.size());
+	outMeshes.reserve(jobs.size());
+	cancelFlags.reserve(jobs.size());
+	faceNormalsAsHardEdges.reserve(jobs.size());
+	outMeshTopologies.reserve(jobs.size());
+	initialShapes.reserve(jobs.size());
 
 	InitialShapeBuilderUPtr isb(prt::InitialShapeBuilder::create());
-	const prt::Status setGeoStatus =
-	        isb->setGeometry(inPrtMesh->vertexCoords(), inPrtMesh->vcCount(), inPrtMesh->indices(),
-	                         inPrtMesh->indicesCount(), inPrtMesh->faceCounts(), inPrtMesh->faceCountsCount());
-	if (setGeoStatus != prt::STATUS_OK)
-		LOG_ERR << "InitialShapeBuilder setGeometry failed status = " << prt::getStatusDescription(setGeoStatus);
+	for (const GenerateJob* job : jobs) {
+		const PRTMesh& prtMesh = *job->prtMesh;
+		const prt::Status setGeoStatus =
+		        isb->setGeometry(prtMesh.vertexCoords(), prtMesh.vcCount(), prtMesh.indices(), prtMesh.indicesCount(),
+		                         prtMesh.faceCounts(), prtMesh.faceCountsCount());
+		if (setGeoStatus != prt::STATUS_OK)
+			LOG_ERR << "InitialShapeBuilder setGeometry failed status = " << prt::getStatusDescription(setGeoStatus);
+
+		isb->setAttributes(job->ruleFile.c_str(), job->startRule.c_str(), job->randomSeed, L"",
+		                   job->generateAttrs.get(), job->resolveMap.get());
+
+		initialShapes.emplace_back(isb->createInitialShapeAndReset());
+		inMeshes.push_back(job->inMesh);
+		outMeshes.push_back(job->outMesh);
+		cancelFlags.push_back(job->canceled);
+		faceNormalsAsHardEdges.push_back(job->faceNormalsAsHardEdges);
+		outMeshTopologies.push_back(job->outMeshTopology);
+	}
 
-	isb->setAttributes(mRuleFile.c_str(), mStartRule.c_str(), mRandomSeed, L"", mGenerateAttrs.get(),
-	                   getResolveMap().get());
+	InitialShapeNOPtrVector shapes;
+	shapes.reserve(initialShapes.size());
+	for (const InitialShapeUPtr& shape : initialShapes)
+		shapes.push_back(shape.get());
 
-	std::unique_ptr<const prt::InitialShape, PRTDestroyer> shape(isb->createInitialShapeAndReset());
+	AttributeMapBuilderUPtr amb(prt::AttributeMapBuilder::create());
+	MayaCallbacks outputHandler(std::move(inMeshes), std::move(outMeshes), amb);
+	outputHandler.setCancelFlags(std::move(cancelFlags));
+	outputHandler.setFaceNormalsAsHardEdges(std::move(faceNormalsAsHardEdges));
+	outputHandler.setOutMeshTopologies(std::move(outMeshTopologies));
 
 	const std::vector<const wchar_t*> encIDs = {ENC_ID_MAYA, ENC_ID_CGA_ERROR, ENC_ID_CGA_PRINT};
-	const AttributeMapNOPtrVector encOpts = {mMayaEncOpts.get(), mCGAErrorOptions.get(), mCGAPrintOptions.get()};
+	const AttributeMapNOPtrVector encOpts = {options.maya.get(), options.cgaError.get(), options.cgaPrint.get()};
 	assert(encIDs.size() == encOpts.size());
 
-	InitialShapeNOPtrVector shapes = {shape.get()};
 	const prt::Status generateStatus =
 	        prt::generate(shapes.data(), shapes.size(), nullptr, encIDs.data(), encIDs.size(), encOpts.data(),
-	                      outputHandler.get(), PRTContext::get().mPRTCache.get(), nullptr);
+	                      &outputHandler, PRTContext::get().mPRTCache.get(), nullptr);
+
+	// canceled initial shapes stop the generate call, which is only a failure if other initial shapes failed too
+	bool anyCanceled = false;
+	bool anyOtherFailed = false;
+	for (size_t i = 0; i < jobs.size(); i++) {
+		jobs[i]->cgacProblems = outputHandler.getCGACErrors(i);
+		jobs[i]->outMeshTopology = outputHandler.getGeneratedTopology(i);
+
+		const bool isCanceled = outputHandler.isCanceled(i);
+		anyCanceled = anyCanceled || isCanceled;
+		anyOtherFailed = anyOtherFailed || (!isCanceled && outputHandler.hasGenerateFailed(i));
+	}
 
-	mCGACProblems = outputHandler->getCGACErrors();
+	if (generateStatus != prt::STATUS_OK && anyCanceled && !anyOtherFailed) {
+		LOG_DBG << "prt generate stopped for canceled initial shapes: " << prt::getStatusDescription(generateStatus);
+	}
+	else if (generateStatus != prt::STATUS_OK) {
+		// reported to the user by the caller, this may run on the background thread of the GenerateScheduler
+		LOG_ERR << "prt generate failed: " << prt::getStatusDescription(generateStatus);
+		for (GenerateJob* job : jobs)
+			job->generateStatus = generateStatus;
+		return MS::kFailure;
+	}
 
-	if (generateStatus != prt::STATUS_OK) {
-		std::string generateFailedMessage = "prt generate failed: ";
-		generateFailedMessage.append(prt::getStatusDescription(generateStatus));
+	return MS::kSuccess;
+}
+
+std::vector<AttributeMapUPtr> PRTModifierAction::evaluateDefaultAttributeValues(
+        const std::vector<PRTModifierAction*>& actions, const std::vector<const RulePackageInfo*>& rulePackages) {
+	assert(actions.size() == rulePackages.size());
+	std::vector<AttributeMapUPtr> defaultAttributeValues(actions.size());
+
+	std::vector<InitialShapeUPtr> initialShapes;
+	std::vector<size_t> actionIndices; // of each initial shape
+	InitialShapeBuilderUPtr isb(prt::InitialShapeBuilder::create());
+	for (size_t i = 0; i < actions.size(); i++) {
+		const RulePackageInfo& rulePackageInfo = *rulePackages[i];
+		if (!rulePackageInfo.ruleFileInfo)
+			continue;
 
-		LOG_ERR << generateFailedMessage;
-		MGlobal::displayError(generateFailedMessage.c_str());
+		const PRTMesh& prtMesh = *actions[i]->inPrtMesh;
+		isb->setGeometry(prtMesh.vertexCoords(), prtMesh.vcCount(), prtMesh.indices(), prtMesh.indicesCount(),
+		                 prtMesh.faceCounts(), prtMesh.faceCountsCount());
+		isb->setAttributes(rulePackageInfo.ruleFile.c_str(), rulePackageInfo.startRule.c_str(),
+		                   actions[i]->mRandomSeed, L"", EMPTY_ATTRIBUTES.get(), rulePackageInfo.resolveMap.get());
+
+		initialShapes.emplace_back(isb->createInitialShapeAndReset());
+		actionIndices.push_back(i);
 	}
+	if (initialShapes.empty())
+		return defaultAttributeValues;
 
-	return status;
+	InitialShapeNOPtrVector shapes;
+	shapes.reserve(initialShapes.size());
+	for (const InitialShapeUPtr& shape : initialShapes)
+		shapes.push_back(shape.get());
+
+	AttributeMapBuilderUPtr amb(prt::AttributeMapBuilder::create());
+	MayaCallbacks mayaCallbacks(std::vector<MObject>(shapes.size()), std::vector<MObject>(shapes.size()), amb);
+	mayaCallbacks.collectAttributesPerInitialShape();
+
+	const std::vector<const wchar_t*> encIDs = {ENC_ID_ATTR_EVAL};
+	const AttributeMapNOPtrVector encOpts = {getAttrEvalEncoderOptions()};
+	assert(encIDs.size() == encOpts.size());
+
+	prt::generate(shapes.data(), shapes.size(), nullptr, encIDs.data(), encIDs.size(), encOpts.data(), &mayaCallbacks,
+	              PRTContext::get().mPRTCache.get(), nullptr);
+
+	for (size_t s = 0; s < shapes.size(); s++)
+		defaultAttributeValues[actionIndices[s]] = mayaCallbacks.createAttributeMap(s);
+
+	return defaultAttributeValues;
+}
+
+MStatus PRTModifierAction::prefetch(const std::vector<PRTModifierAction*>& actions) {
+	const MStatus status = generate(actions);
+	if (status != MS::kSuccess)
+		return status;
+
+	for (PRTModifierAction* action : actions) {
+		action->mPrefetchedOutput = PrefetchedOutput{action->outMesh, action->getGenerateDigest(),
+		                                             action->mCGACProblems, action->mOutMeshTopology};
+		action->mOutMeshTopology.reset(); // the prefetched mesh is not in the output mesh yet
+
+		// the node attributes were just created with their default values, so none of them can be user set
+		for (NodeRuleAttribute& nodeAttribute : action->mNodeRuleAttributes)
+			nodeAttribute.dirty = false;
+
+		// without user values the defaults shown in the UI are the ones updateRuleFiles() evaluated
+		size_t userValueCount = 0;
+		action->mGenerateAttrs->getKeys(&userValueCount);
+		if (userValueCount == 0)
+			action->mUIDigest = action->getGenerateDigest();
+	}
+
+	return MS::kSuccess;
+}
+
+uint64_t PRTModifierAction::getGenerateDigest() const {
+	prtu::Fnv1aHash digest;
+
+	addToDigest(digest, mRulePkg.asWChar());
+	addToDigest(digest, mRuleFile);
+	addToDigest(digest, mStartRule);
+	digest.add(mRandomSeed);
+	digest.add(mLevelOfDetail);
+	digest.add(mEmitMaterials);
+	digest.add(mEmitReports);
+	digest.add(mFaceNormalsAsHardEdges);
+
+	if (inPrtMesh)
+		digest.add(inPrtMesh->hash());
+
+	if (mGenerateAttrs)
+		digest.add(mGenerateAttrsDigest);
+
+	return digest.value();
 }
 
 MStatus PRTModifierAction::createNodeAttributes(const RuleAttributeSet& ruleAttributes, const MObject& nodeObj,
@@ -1001,10 +1381,79 @@ MStatus PRTModifierAction::createNodeAttributes(const RuleAttributeSet& ruleAttr
 	} // for all mGenerateAttrs keys
 
 	removeUnusedAttribs(node);
+	updateNodeRuleAttributes(node);
 
 	return MS::kSuccess;
 }
 
+void PRTModifierAction::updateNodeRuleAttributes(const MFnDependencyNode& node) {
+	mNodeRuleAttributes.clear();
+	mNodeRuleAttributeIndices.clear();
+	mGenerateAttrsDirty = true;
+	mUIDigest.reset();
+
+	for (unsigned int i = 0, numAttrs = node.attributeCount(); i < numAttrs; i++) {
+		MStatus attrStat;
+		const MObject attrObj = node.attribute(i, &attrStat);
+		if (attrStat != MS::kSuccess)
+			continue;
+
+		const MFnAttribute fnAttr(attrObj);
+
+		// CGA rule attributes are maya dynamic attributes and not hidden
+		// maya annoyance: color attributes automatically get per-component child attrs, skip them
+		if (!fnAttr.isDynamic() || fnAttr.isHidden() || !fnAttr.parent().isNull())
+			continue;
+
+		const auto ruleAttrIt = mRuleAttributes.find(fnAttr.name().asWChar());
+		if (ruleAttrIt == mRuleAttributes.end())
+			continue;
+
+		NodeRuleAttribute nodeAttribute;
+		nodeAttribute.attribute = attrObj;
+		nodeAttribute.userSetAttribute = node.attribute(fnAttr.name() + ATTRIBUTE_USER_SET_SUFFIX);
+		nodeAttribute.forceDefaultAttribute = node.attribute(fnAttr.name() + ATTRIBUTE_FORCE_DEFAULT_SUFFIX);
+		nodeAttribute.ruleAttribute = ruleAttrIt->second;
+
+		MAYBE_UNUSED const auto ruleAttrType = nodeAttribute.ruleAttribute.mType;
+
+		if (attrObj.hasFn(MFn::kNumericAttribute)) {
+			MFnNumericAttribute nAttr(attrObj);
+
+			if (nAttr.unitType() == MFnNumericData::kBoolean) {
+				assert(ruleAttrType == prt::AAT_BOOL);
+				nodeAttribute.type = PrtAttributeType::BOOL;
+			}
+			else if (nAttr.unitType() == MFnNumericData::kDouble) {
+				assert(ruleAttrType == prt::AAT_FLOAT);
+				nodeAttribute.type = PrtAttributeType::FLOAT;
+			}
+			else if (nAttr.isUsedAsColor()) {
+				assert(ruleAttrType == prt::AAT_STR);
+				nodeAttribute.type = PrtAttributeType::COLOR;
+			}
+			else
+				continue;
+		}
+		else if (attrObj.hasFn(MFn::kTypedAttribute)) {
+			assert(ruleAttrType == prt::AAT_STR);
+			nodeAttribute.type = PrtAttributeType::STRING;
+		}
+		else if (attrObj.hasFn(MFn::kEnumAttribute)) {
+			nodeAttribute.type = PrtAttributeType::ENUM;
+		}
+		else
+			continue;
+
+		const MString attrName = fnAttr.name();
+		for (const MString& name :
+		     {attrName, attrName + ATTRIBUTE_USER_SET_SUFFIX, attrName + ATTRIBUTE_FORCE_DEFAULT_SUFFIX})
+			mNodeRuleAttributeIndices.emplace(name.asWChar(), mNodeRuleAttributes.size());
+
+		mNodeRuleAttributes.push_back(std::move(nodeAttribute));
+	}
+}
+
 void PRTModifierAction::removeUnusedAttribs(MFnDependencyNode& node) {
 	auto isInUse = [this](const MString& attrName) {
 		const std::wstring attrNameWithoutSuffix = removeSuffix(attrName.asWChar());
@@ -31,6 +31,7 @@
 
 #include "prt/API.h"
 
+#include "maya/MDataBlock.h"
 #include "maya/MDoubleArray.h"
 #include "maya/MIntArray.h"
 #include "maya/MObject.h"
@@ -38,13 +39,77 @@
 #include "maya/MString.h"
 #include "maya/MStringArray.h"
 
+#include <atomic>
 #include <list>
 #include <map>
+#include <memory>
+#include <optional>
 #include <variant>
+#include <vector>
 
 class PRTModifierAction;
 
 using PRTEnumDefaultValue = std::variant<bool, double, MString>;
+using RuleAttributeValue = std::variant<bool, double, std::wstring>;
+
+// see PRTModifierNode::levelOfDetail
+enum class LevelOfDetail : short { FULL = 0, PREVIEW = 1, BOUNDING_BOXES = 2 };
+
+enum class PrtAttributeType { BOOL, FLOAT, COLOR, STRING, ENUM };
+
+// a dynamic rule attribute of the node together with its hidden companion attributes
+struct NodeRuleAttribute {
+	MObject attribute;
+	MObject userSetAttribute;      // null if missing
+	MObject forceDefaultAttribute; // null if missing
+	PrtAttributeType type = PrtAttributeType::BOOL;
+	RuleAttribute ruleAttribute;
+
+	bool dirty = true;                          // set by PRTModifierAction::setAttributeDirty()
+	std::optional<RuleAttributeValue> userValue; // the value passed to the rule, empty if not user set
+};
+
+// everything needed to generate one initial shape, independent of the action so it can outlive a compute
+struct GenerateJob {
+	std::shared_ptr<const PRTMesh> prtMesh;
+	ResolveMapSPtr resolveMap;
+	std::wstring ruleFile;
+	std::wstring startRule;
+	int32_t randomSeed = 0;
+	LevelOfDetail levelOfDetail = LevelOfDetail::FULL;
+	bool emitMaterials = true;
+	bool emitReports = false;
+	bool faceNormalsAsHardEdges = false;
+	AttributeMapSPtr generateAttrs;
+	MObject inMesh;
+	MObject outMesh;
+	std::optional<uint64_t> outMeshTopology;     // of the generated mesh outMesh holds, updated by generate()
+	const std::atomic<bool>* canceled = nullptr; // optional, stops generating the job as soon as it is set
+	CGACErrors cgacProblems;                     // set by PRTModifierAction::generate()
+	prt::Status generateStatus = prt::STATUS_OK; // set by PRTModifierAction::generate(), OK if only canceled
+};
+
+// what a rule package provides independent of the node, loaded once for all nodes using it
+struct RulePackageInfo {
+	ResolveMapSPtr resolveMap;
+	std::wstring ruleFile;
+	std::wstring startRule;
+	RuleFileInfoUPtr ruleFileInfo; // null if the rule package could not be loaded
+	CGACErrors problems;           // why the rule package could not be loaded
+};
+
+// a job generated on the background thread of the GenerateScheduler, on detached copies of the node's meshes
+struct AsyncGenerateJob : GenerateJob {
+	AsyncGenerateJob() {
+		canceled = &superseded;
+	}
+
+	uint64_t generateDigest = 0;
+	std::wstring nodeUuid;
+	std::atomic<bool> superseded{false}; // the node inputs changed since the job was started
+	std::atomic<bool> done{false};
+	bool failureReported = false; // only accessed by the node on the main thread
+};
 
 class PRTModifierAction : public polyModifierFty {
 	friend class PRTModifierEnum;
@@ -53,29 +118,82 @@ public:
 	explicit PRTModifierAction();
 
 	MStatus updateRuleFiles(const MObject& node, const MString& rulePkg, MObject& cgacProblemObject);
-	MStatus fillAttributesFromNode(const MObject& node);
+	// as above, but with an already loaded rule package and without flushing the PRT cache
+	// the default attribute values are evaluated for the input mesh unless given, see evaluateDefaultAttributeValues()
+	MStatus updateRuleFiles(const MObject& node, const MString& rulePkg, const RulePackageInfo& rulePackageInfo,
+	                        MObject& cgacProblemObject, AttributeMapUPtr defaultAttributeValues = {});
+	// loads the rule file information of rulePkg, the caller is responsible for flushing the PRT cache beforehand
+	static MStatus loadRulePackage(const MString& rulePkg, RulePackageInfo& rulePackageInfo);
+	// reads the attribute values from data if called during compute, otherwise from the plugs of node
+	// only re-reads the attributes dirtied since the last call and keeps mGenerateAttrs if none of them changed
+	MStatus fillAttributesFromNode(const MObject& node, MDataBlock* data = nullptr);
+	// records that the rule attribute of plug (or one of its companions) needs to be re-read
+	void setAttributeDirty(const MPlug& plug);
 	MStatus updateUserSetAttributes(const MObject& node);
 	MStatus updateUI(const MObject& node, MObject& cgacProblemObject);
-	void setMesh(MObject& _inMesh, MObject& _outMesh);
+	// keeps the PRT representation of the previous input mesh if inMeshChanged is false
+	// keepsGeneratedOutMesh: _outMesh still holds the mesh of the last generate, see hasGeneratedOutMesh()
+	void setMesh(MObject& _inMesh, MObject& _outMesh, bool inMeshChanged = true, bool keepsGeneratedOutMesh = false);
+	// true if the last doIt() generated into the output mesh, compute can then hand over the output mesh instead of a
+	// copy of the input mesh and a generated mesh with unchanged topology only updates its points and normals
+	bool hasGeneratedOutMesh() const {
+		return mOutMeshTopology.has_value();
+	}
+	void discardGeneratedOutMesh() {
+		mOutMeshTopology.reset();
+	}
 	void setRandomSeed(int32_t randomSeed) {
 		mRandomSeed = randomSeed;
 	};
+	void setLevelOfDetail(LevelOfDetail levelOfDetail) {
+		if (levelOfDetail != mLevelOfDetail)
+			mGenerateAttrsDirty = true;
+		mLevelOfDetail = levelOfDetail;
+	};
+	// the material metadata is only needed if a serlio material node consumes the generated mesh
+	void setEmitMaterials(bool emitMaterials) {
+		mEmitMaterials = emitMaterials;
+	};
+	void setFaceNormalsAsHardEdges(bool faceNormalsAsHardEdges) {
+		mFaceNormalsAsHardEdges = faceNormalsAsHardEdges;
+	};
+	// the CGA reports are stored in the mesh metadata, see ReportInfo.h
+	void setEmitReports(bool emitReports) {
+		mEmitReports = emitReports;
+	};
 
 	// polyModifierFty inherited methods
 	MStatus doIt() override;
 
-private:
-	// init in PRTModifierAction::PRTModifierAction()
-	AttributeMapUPtr mMayaEncOpts;
-	AttributeMapUPtr mCGAPrintOptions;
-	AttributeMapUPtr mCGAErrorOptions;
+	// starts generating on the background thread and outputs the last finished result (or the unchanged input mesh
+	// as a proxy) until then. the node is dirtied when the job is done and picks up the new result on its next compute
+	MStatus doItAsync(const MObject& node);
+
+	// generates all jobs with a single prt::generate call, one initial shape per job
+	static MStatus generate(const std::vector<GenerateJob*>& jobs);
+
+	// generates all actions with a single prt::generate call, one initial shape per action
+	static MStatus generate(const std::vector<PRTModifierAction*>& actions);
+
+	// evaluates the default attribute values of rulePackages[i] for the input mesh of actions[i] with a single
+	// prt::generate call, the result is empty for rule packages which could not be loaded
+	static std::vector<AttributeMapUPtr> evaluateDefaultAttributeValues(
+	        const std::vector<PRTModifierAction*>& actions, const std::vector<const RulePackageInfo*>& rulePackages);
+
+	// generates all actions in one batch and keeps the results for their next doIt() with unchanged inputs
+	static MStatus prefetch(const std::vector<PRTModifierAction*>& actions);
+
+	void discardPrefetchedOutput() {
+		mPrefetchedOutput.reset();
+	}
 
+private:
 	// Mesh Nodes: only used during doIt
 	MObject inMesh;
 	MObject outMesh;
 
 	// PRT representation for the geometry of inMesh
-	std::unique_ptr<PRTMesh> inPrtMesh;
+	std::shared_ptr<const PRTMesh> inPrtMesh;
 
 	// Set in updateRuleFiles(rulePkg)
 	MString mRulePkg;
@@ -84,18 +202,55 @@ private:
 	std::wstring mStartRule;
 	const std::wstring mRuleStyle = L"Default"; // Serlio atm only supports the "Default" style
 	int32_t mRandomSeed = 0;
+	LevelOfDetail mLevelOfDetail = LevelOfDetail::FULL;
+	bool mEmitMaterials = true;
+	bool mEmitReports = false;
+	bool mFaceNormalsAsHardEdges = false;
+	std::optional<uint64_t> mOutMeshTopology; // of the generated mesh outMesh holds, see hasGeneratedOutMesh()
 	RuleAttributeMap mRuleAttributes; // TODO: could be cached together with ResolveMap
 
-	ResolveMapSPtr getResolveMap();
+	// the rule attributes present on the node, rebuilt whenever the node attributes are (re)created
+	std::vector<NodeRuleAttribute> mNodeRuleAttributes;
+	// maya attribute names (including the companions) to the index of their entry in mNodeRuleAttributes
+	std::map<std::wstring, size_t> mNodeRuleAttributeIndices;
+
+	ResolveMapSPtr getResolveMap() const;
 
 	// init in fillAttributesFromNode()
-	AttributeMapUPtr mGenerateAttrs;
+	AttributeMapSPtr mGenerateAttrs;
+	uint64_t mGenerateAttrsDigest = 0; // hash of the values in mGenerateAttrs, computed while building it
+	bool mGenerateAttrsDirty = true; // rebuild mGenerateAttrs even if no attribute value changed
+
+	// generate digest of the last updateUI() pass over the attributes, their defaults only change with it
+	std::optional<uint64_t> mUIDigest;
+
+	// reused for the attribute evaluation and fillAttributesFromNode(), always reset after use
+	InitialShapeBuilderUPtr mInitialShapeBuilder;
+	AttributeMapBuilderUPtr mAttributeMapBuilder;
+
+	// set by prefetch(), consumed or discarded by the next compute
+	struct PrefetchedOutput {
+		MObject meshData;
+		uint64_t generateDigest;
+		CGACErrors cgacProblems;
+		std::optional<uint64_t> topology;
+	};
+	std::optional<PrefetchedOutput> mPrefetchedOutput;
+
+	// set by doItAsync(), reset by doIt()
+	std::shared_ptr<AsyncGenerateJob> mAsyncJob;
+	MObject mAsyncOutput; // mesh data of the last finished async job
+
+	uint64_t getGenerateDigest() const;
+	void fillGenerateJob(GenerateJob& job) const;
+	void cancelAsyncJob();
 
 	std::map<std::wstring, PRTModifierEnum> mEnums;
 
 	MStatus createNodeAttributes(const RuleAttributeSet& ruleAttributes, const MObject& node,
 	                             const prt::RuleFileInfo* info);
 	void removeUnusedAttribs(MFnDependencyNode& node);
+	void updateNodeRuleAttributes(const MFnDependencyNode& node);
 
 	static MStatus addParameter(MFnDependencyNode& node, MObject& attr, MFnAttribute& tAttr);
 	static MStatus addBoolParameter(MFnDependencyNode& node, MObject& attr, const RuleAttribute& name,
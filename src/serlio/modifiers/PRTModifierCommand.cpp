@@ -28,6 +28,8 @@
 #include "maya/MGlobal.h"
 #include "maya/MItSelectionList.h"
 
+#include <algorithm>
+
 bool PRTModifierCommand::isUndoable() const {
 	return true;
 }
@@ -50,65 +52,74 @@ MStatus PRTModifierCommand::doIt(const MArgList& argList) {
 	MItSelectionList selListIter(selList);
 	selListIter.setFilter(MFn::kMesh);
 
-	bool found = false;
-	bool foundMultiple = false;
-
+	std::vector<MDagPath> meshPaths;
 	for (; !selListIter.isDone(); selListIter.next()) {
 		MDagPath dagPath;
 		MObject component;
 		selListIter.getDagPath(dagPath, component);
 
-		if (!found) {
-			// Ensure that this DAG path will point to the shape
-			// of our object. Set the DAG path for the polyModifierCmd.
-			if ((dagPath.extendToShape() == MStatus::kSuccess) ||
-			    (dagPath.extendToShapeDirectlyBelow(0) == MStatus::kSuccess)) {
-				setMeshNode(dagPath);
-				found = true;
-			}
-		}
-		else {
-			foundMultiple = true;
-			break;
+		// Ensure that this DAG path will point to the shape of our object.
+		if ((dagPath.extendToShape() == MStatus::kSuccess) ||
+		    (dagPath.extendToShapeDirectlyBelow(0) == MStatus::kSuccess)) {
+			// transform and shape of the same object may both be selected
+			if (std::find(meshPaths.begin(), meshPaths.end(), dagPath) == meshPaths.end())
+				meshPaths.push_back(dagPath);
 		}
 	}
-	if (foundMultiple) {
-		displayWarning("Found more than one object with selected components. Only operating on first found object.");
+
+	if (meshPaths.empty()) {
+		displayError("PRT command failed: Unable to find selected components");
+		return MS::kFailure;
 	}
 
-	// Initialize the polyModifierCmd node type - mesh node already set
-	//
-	setModifierNodeType(PRTModifierNode::id);
+	mMeshCommands.clear();
+	mMeshCommands.reserve(meshPaths.size());
+	for (const MDagPath& meshPath : meshPaths) {
+		auto meshCommand = std::make_unique<PRTModifierCommand>();
+		meshCommand->mRulePkg = mRulePkg;
+		meshCommand->setMeshNode(meshPath);
+		meshCommand->setModifierNodeType(PRTModifierNode::id);
 
-	if (found) {
-		MFnMesh meshFn(getMeshNode());
+		MFnMesh meshFn(meshPath);
 
 		MFloatPointArray vertices;
 		MCHECK(meshFn.getPoints(vertices, MSpace::kWorld));
-		mInitialSeed = mu::computeSeed(vertices);
+		meshCommand->mInitialSeed = mu::computeSeed(vertices);
 
 		// Now, pass control over to the polyModifierCmd::doModifyPoly() method
 		// to handle the operation.
-		status = doModifyPoly();
+		status = meshCommand->doModifyPoly();
+		if (status != MS::kSuccess) {
+			// leave the scene as it was before the command
+			for (auto it = mMeshCommands.rbegin(); it != mMeshCommands.rend(); ++it)
+				(*it)->undoModifyPoly();
+			mMeshCommands.clear();
 
-		if (status == MS::kSuccess) {
-			setResult("PRT command succeeded!");
-		}
-		else {
 			displayError("PRT command failed!");
+			return status;
 		}
-	}
-	else {
-		displayError("PRT command failed: Unable to find selected components");
-		status = MS::kFailure;
+
+		mMeshCommands.push_back(std::move(meshCommand));
 	}
 
-	return status;
+	// generate all new nodes in one batch, their first compute then only picks up the result
+	std::vector<MObject> modifierNodes;
+	modifierNodes.reserve(mMeshCommands.size());
+	for (const auto& meshCommand : mMeshCommands)
+		modifierNodes.push_back(meshCommand->mModifierNode);
+	MCHECK(PRTModifierNode::prefetch(modifierNodes));
+
+	setResult("PRT command succeeded!");
+	return MS::kSuccess;
 }
 
 MStatus PRTModifierCommand::redoIt() {
 	MStatus status;
-	status = redoModifyPoly();
+	for (const auto& meshCommand : mMeshCommands) {
+		status = meshCommand->redoModifyPoly();
+		if (status != MS::kSuccess)
+			break;
+	}
 
 	if (status == MS::kSuccess) {
 		setResult("PRT command succeeded!");
@@ -122,7 +133,12 @@ MStatus PRTModifierCommand::redoIt() {
 
 MStatus PRTModifierCommand::undoIt() {
 	MStatus status;
-	status = undoModifyPoly();
+	for (auto it = mMeshCommands.rbegin(); it != mMeshCommands.rend(); ++it) {
+		status = (*it)->undoModifyPoly();
+		if (status != MS::kSuccess)
+			break;
+	}
+
 	if (status == MS::kSuccess) {
 		setResult("PRT undo succeeded!");
 	}
@@ -144,5 +160,7 @@ MStatus PRTModifierCommand::initModifierNode(MObject modifierNode) {
 	MPlug plugRnd(modifierNode, attrSeed);
 	plugRnd.setValue(mInitialSeed);
 
+	mModifierNode = modifierNode;
+
 	return status;
 }
@@ -23,6 +23,9 @@
 
 #include "PRTContext.h"
 
+#include <memory>
+#include <vector>
+
 // based on the splitUVCommand and meshOpCommand Maya example .
 class PRTModifierCommand : public polyModifierCmd {
 public:
@@ -37,4 +40,8 @@ public:
 private:
 	MString mRulePkg;
 	int32_t mInitialSeed = 0;
+	MObject mModifierNode;
+
+	// one history insertion per selected mesh, each keeps its own undo state
+	std::vector<std::unique_ptr<PRTModifierCommand>> mMeshCommands;
 };
@@ -19,16 +19,22 @@
 
 #include "modifiers/PRTModifierNode.h"
 
+#include "materials/ArnoldMaterialNode.h"
+#include "materials/StingrayMaterialNode.h"
+
 #include "utils/MayaUtilities.h"
 
 #include "serlioPlugin.h"
 
 #include "maya/MDataHandle.h"
+#include "maya/MFnDependencyNode.h"
+#include "maya/MFnMesh.h"
 #include "maya/MFnMeshData.h"
 #include "maya/MFnNumericAttribute.h"
 #include "maya/MFnStringArrayData.h"
 #include "maya/MFnStringData.h"
 #include "maya/MFnTypedAttribute.h"
+#include "maya/MItDependencyGraph.h"
 
 #define MCheckStatus(status, message)                                                                                  \
 	if (MStatus::kSuccess != (status)) {                                                                               \
@@ -39,7 +45,16 @@
 namespace {
 const MString NAME_RULE_PKG = "Rule_Package";
 const MString NAME_RANDOM_SEED = "Random_Seed";
+const MString NAME_ASYNC_GENERATE = "Async_Generate";
+const MString NAME_LEVEL_OF_DETAIL = "Level_Of_Detail";
+const MString NAME_FACE_NORMALS_AS_HARD_EDGES = "Face_Normals_As_Hard_Edges";
+const MString NAME_EMIT_REPORTS = "Emit_Reports";
 const MString CGAC_PROBLEMS = "CGAC_Problems";
+
+bool isMaterialNode(const MObject& node) {
+	const MTypeId typeId = MFnDependencyNode(node).typeId();
+	return (typeId == StingrayMaterialNode::id) || (typeId == ArnoldMaterialNode::id);
+}
 } // namespace
 
 // Unique Node TypeId
@@ -48,14 +63,85 @@ MObject PRTModifierNode::rulePkg;
 MObject PRTModifierNode::cgacProblems;
 MObject PRTModifierNode::currentRulePkg;
 MObject PRTModifierNode::mRandomSeed;
+MObject PRTModifierNode::asyncGenerate;
+MObject PRTModifierNode::levelOfDetail;
+MObject PRTModifierNode::faceNormalsAsHardEdges;
+MObject PRTModifierNode::emitReports;
+MObject PRTModifierNode::updateTrigger;
 
 // make sure the dynamically added plugs affect the outMesh
-MStatus PRTModifierNode::setDependentsDirty(const MPlug& /*plugBeingDirtied*/, MPlugArray& affectedPlugs) {
+MStatus PRTModifierNode::setDependentsDirty(const MPlug& plugBeingDirtied, MPlugArray& affectedPlugs) {
+	fPRTModifierAction.setAttributeDirty(plugBeingDirtied);
+
 	const MPlug pOutMesh(thisMObject(), outMesh);
 	affectedPlugs.append(pOutMesh);
 	return MS::kSuccess;
 }
 
+void PRTModifierNode::connectionChanged(MPlug& srcPlug, MPlug& destPlug, bool /*made*/, void* /*clientData*/) {
+	const auto updateModifierNode = [](const MObject& node) {
+		auto* modifierNode = dynamic_cast<PRTModifierNode*>(MFnDependencyNode(node).userNode());
+		if (modifierNode != nullptr)
+			modifierNode->updateMaterialConsumer();
+	};
+
+	MObject srcNode = srcPlug.node();
+	if ((srcPlug == outMesh) && (MFnDependencyNode(srcNode).typeId() == id)) {
+		updateModifierNode(srcNode);
+		return;
+	}
+
+	// a material node connected further downstream also changes the consumers of the serlio nodes above it
+	for (MObject node : {srcNode, destPlug.node()}) {
+		if (!isMaterialNode(node))
+			continue;
+
+		MStatus status;
+		MItDependencyGraph it(node, MFn::kInvalid, MItDependencyGraph::kUpstream, MItDependencyGraph::kDepthFirst,
+		                      MItDependencyGraph::kNodeLevel, &status);
+		MCHECK(status);
+		for (; (status == MS::kSuccess) && !it.isDone(); it.next()) {
+			const MObject currentNode = it.currentItem();
+			if (MFnDependencyNode(currentNode).typeId() == id) {
+				updateModifierNode(currentNode);
+				it.prune();
+			}
+		}
+	}
+}
+
+void PRTModifierNode::updateMaterialConsumer() {
+	bool hasMaterialConsumer = false;
+
+	MStatus status;
+	MObject node = thisMObject();
+	MItDependencyGraph it(node, MFn::kInvalid, MItDependencyGraph::kDownstream, MItDependencyGraph::kDepthFirst,
+	                      MItDependencyGraph::kNodeLevel, &status);
+	MCHECK(status);
+	for (; (status == MS::kSuccess) && !it.isDone(); it.next()) {
+		const MObject currentNode = it.currentItem();
+		if (isMaterialNode(currentNode)) {
+			hasMaterialConsumer = true;
+			break;
+		}
+
+		// material nodes are inserted between the generating node and the mesh shape
+		if (currentNode.hasFn(MFn::kMesh))
+			it.prune();
+	}
+
+	// the current output lacks the materials a newly connected material node needs
+	const bool needsUpdate = hasMaterialConsumer && (mHasMaterialConsumer == false);
+	mHasMaterialConsumer = hasMaterialConsumer;
+	if (needsUpdate)
+		triggerUpdate(node);
+}
+
+void PRTModifierNode::triggerUpdate(const MObject& node) {
+	MPlug updateTriggerPlug(node, updateTrigger);
+	MCHECK(updateTriggerPlug.setInt(updateTriggerPlug.asInt() + 1));
+}
+
 // This method computes the value of the given output plug based
 // on the values of the input attributes. Based on the Maya example splitUvCmd
 MStatus PRTModifierNode::compute(const MPlug& plug, MDataBlock& data) {
@@ -64,6 +150,9 @@ MStatus PRTModifierNode::compute(const MPlug& plug, MDataBlock& data) {
 	MDataHandle stateData = data.outputValue(state, &status);
 	MCheckStatus(status, "ERROR getting state");
 
+	// inputValue() cleans inMesh, so remember whether the input geometry changed until the next generate
+	mInMeshChanged = mInMeshChanged || !data.isClean(inMesh);
+
 	// Check for the HasNoEffect/PassThrough flag on the node.
 	// (stateData is an enumeration standard in all depend nodes)
 	//
@@ -79,6 +168,7 @@ MStatus PRTModifierNode::compute(const MPlug& plug, MDataBlock& data) {
 
 		// Simply redirect the inMesh to the outMesh for the PassThrough effect
 		outputData.set(inputData.asMesh());
+		fPRTModifierAction.discardGeneratedOutMesh();
 	}
 	else {
 		// Check which output attribute we have been asked to
@@ -102,13 +192,17 @@ MStatus PRTModifierNode::compute(const MPlug& plug, MDataBlock& data) {
 
 			// Copy the inMesh to the outMesh, so you can
 			// perform operations directly on outMesh
+			// (unless outMesh still holds the last generated mesh, which can then be updated in place)
 			//
-			outputData.set(inputData.asMesh());
-			MObject iMesh = outputData.asMesh();
+			const bool keepOutMesh = fPRTModifierAction.hasGeneratedOutMesh();
+			if (!keepOutMesh)
+				outputData.set(inputData.asMesh());
+			MObject iMesh = keepOutMesh ? inputData.asMesh() : outputData.asMesh();
 			MObject oMesh = outputData.asMesh();
 
 			// Set the mesh object and component List on the factory
-			fPRTModifierAction.setMesh(iMesh, oMesh);
+			fPRTModifierAction.setMesh(iMesh, oMesh, mInMeshChanged, keepOutMesh);
+			mInMeshChanged = false;
 
 			if (!ruleFileWasChanged)
 				fPRTModifierAction.updateUserSetAttributes(thisMObject());
@@ -116,20 +210,44 @@ MStatus PRTModifierNode::compute(const MPlug& plug, MDataBlock& data) {
 			MDataHandle randomSeed = data.inputValue(mRandomSeed, &status);
 			fPRTModifierAction.setRandomSeed(randomSeed.asInt());
 
+			MDataHandle levelOfDetailData = data.inputValue(levelOfDetail, &status);
+			MCheckStatus(status, "ERROR getting levelOfDetail");
+			fPRTModifierAction.setLevelOfDetail(static_cast<LevelOfDetail>(levelOfDetailData.asShort()));
+			fPRTModifierAction.setEmitMaterials(hasMaterialConsumer());
+
+			MDataHandle faceNormalsAsHardEdgesData = data.inputValue(faceNormalsAsHardEdges, &status);
+			MCheckStatus(status, "ERROR getting faceNormalsAsHardEdges");
+			fPRTModifierAction.setFaceNormalsAsHardEdges(faceNormalsAsHardEdgesData.asBool());
+
+			MDataHandle emitReportsData = data.inputValue(emitReports, &status);
+			MCheckStatus(status, "ERROR getting emitReports");
+			fPRTModifierAction.setEmitReports(emitReportsData.asBool());
+
 			if (ruleFileWasChanged) {
 				status = fPRTModifierAction.updateRuleFiles(thisMObject(), rulePkgData.asString(), cgacProblems);
 
 				if (status != MStatus::kSuccess) {
+					fPRTModifierAction.discardPrefetchedOutput();
 					return status;
 				}
 			}
 
-			status = fPRTModifierAction.fillAttributesFromNode(thisMObject());
-			if (status != MStatus::kSuccess)
+			status = fPRTModifierAction.fillAttributesFromNode(thisMObject(), &data);
+			if (status != MStatus::kSuccess) {
+				fPRTModifierAction.discardPrefetchedOutput();
 				return status;
+			}
 
 			// Now, perform the PRT
-			status = fPRTModifierAction.doIt();
+			MDataHandle asyncGenerateData = data.inputValue(asyncGenerate, &status);
+			MCheckStatus(status, "ERROR getting asyncGenerate");
+
+			if (asyncGenerateData.asBool()) {
+				status = fPRTModifierAction.doItAsync(thisMObject());
+			}
+			else {
+				status = fPRTModifierAction.doIt();
+			}
 
 			fPRTModifierAction.updateUI(thisMObject(), cgacProblems);
 
@@ -141,9 +259,83 @@ MStatus PRTModifierNode::compute(const MPlug& plug, MDataBlock& data) {
 		}
 	}
 
+	// a prefetched result is only meant for the first compute after prefetch(), e.g. not if it passed through
+	fPRTModifierAction.discardPrefetchedOutput();
+
 	return status;
 }
 
+MStatus PRTModifierNode::prefetch(const std::vector<MObject>& nodes) {
+	std::vector<MObject> modifierNodes;
+	std::vector<PRTModifierAction*> actions;
+	std::vector<MString> nodeRulePkgs;
+	std::vector<const RulePackageInfo*> nodeRulePackages;
+
+	// flush once for the whole batch and load each distinct rule package only once
+	PRTContext::get().mPRTCache.get()->flushAll();
+	std::map<std::wstring, RulePackageInfo> rulePackages;
+
+	for (const MObject& node : nodes) {
+		MStatus status;
+		MFnDependencyNode fnNode(node, &status);
+		auto* modifierNode = dynamic_cast<PRTModifierNode*>(fnNode.userNode());
+		if (status != MS::kSuccess || modifierNode == nullptr)
+			continue;
+
+		// generate into a detached copy of the input, compute copies the result into the output data block
+		const MObject inMeshObj = MPlug(node, inMesh).asMObject(&status);
+		if (status != MS::kSuccess || inMeshObj.isNull())
+			continue;
+
+		MFnMeshData dataCreator;
+		MObject meshData = dataCreator.create(&status);
+		if (status == MS::kSuccess)
+			MFnMesh().copy(inMeshObj, meshData, &status);
+		if (status != MS::kSuccess)
+			continue;
+
+		PRTModifierAction& action = modifierNode->fPRTModifierAction;
+		action.setMesh(meshData, meshData);
+		action.setRandomSeed(MPlug(node, mRandomSeed).asInt());
+		action.setLevelOfDetail(static_cast<LevelOfDetail>(MPlug(node, levelOfDetail).asShort()));
+		action.setEmitMaterials(modifierNode->hasMaterialConsumer());
+		action.setFaceNormalsAsHardEdges(MPlug(node, faceNormalsAsHardEdges).asBool());
+		action.setEmitReports(MPlug(node, emitReports).asBool());
+
+		const MString rulePkgValue = MPlug(node, rulePkg).asString();
+		auto [rulePackage, isNew] = rulePackages.try_emplace(rulePkgValue.asWChar());
+		if (isNew)
+			PRTModifierAction::loadRulePackage(rulePkgValue, rulePackage->second);
+
+		modifierNodes.push_back(node);
+		actions.push_back(&action);
+		nodeRulePkgs.push_back(rulePkgValue);
+		nodeRulePackages.push_back(&rulePackage->second);
+	}
+
+	// the default attribute values depend on the mesh of each node, evaluate them in one batch as well
+	std::vector<AttributeMapUPtr> defaultAttributeValues =
+	        PRTModifierAction::evaluateDefaultAttributeValues(actions, nodeRulePackages);
+
+	std::vector<PRTModifierAction*> prefetchActions;
+	prefetchActions.reserve(actions.size());
+	for (size_t i = 0; i < actions.size(); i++) {
+		const MObject& node = modifierNodes[i];
+		PRTModifierAction& action = *actions[i];
+		if (action.updateRuleFiles(node, nodeRulePkgs[i], *nodeRulePackages[i], cgacProblems,
+		                           std::move(defaultAttributeValues[i])) != MS::kSuccess)
+			continue;
+		// the rule attributes are up to date, compute must not reload the rule package
+		MPlug(node, currentRulePkg).setString(nodeRulePkgs[i]);
+		if (action.fillAttributesFromNode(node) != MS::kSuccess)
+			continue;
+
+		prefetchActions.push_back(&action);
+	}
+
+	return PRTModifierAction::prefetch(prefetchActions);
+}
+
 MStatus PRTModifierNode::initialize()
 // Description:
 //  This method is called to create and initialize all of the attributes
@@ -206,6 +398,51 @@ MStatus PRTModifierNode::initialize()
 	MCHECK(addAttribute(mRandomSeed));
 	MCHECK(attributeAffects(mRandomSeed, outMesh));
 
+	asyncGenerate = nAttr.create(NAME_ASYNC_GENERATE, "asyncGenerate", MFnNumericData::kBoolean, false, &stat);
+	MCHECK(stat);
+	MCHECK(nAttr.setCached(true));
+	MCHECK(nAttr.setStorable(true));
+	MCHECK(nAttr.setNiceNameOverride(MString("Generate Asynchronously")));
+	MCHECK(addAttribute(asyncGenerate));
+	MCHECK(attributeAffects(asyncGenerate, outMesh));
+
+	levelOfDetail =
+	        enumFn.create(NAME_LEVEL_OF_DETAIL, "levelOfDetail", static_cast<short>(LevelOfDetail::FULL), &stat);
+	MCHECK(stat);
+	MCHECK(enumFn.addField("Full", static_cast<short>(LevelOfDetail::FULL)));
+	MCHECK(enumFn.addField("Preview", static_cast<short>(LevelOfDetail::PREVIEW)));
+	MCHECK(enumFn.addField("Bounding Boxes", static_cast<short>(LevelOfDetail::BOUNDING_BOXES)));
+	MCHECK(enumFn.setCached(true));
+	MCHECK(enumFn.setStorable(true));
+	MCHECK(enumFn.setNiceNameOverride(MString("Level of Detail")));
+	MCHECK(addAttribute(levelOfDetail));
+	MCHECK(attributeAffects(levelOfDetail, outMesh));
+
+	faceNormalsAsHardEdges = nAttr.create(NAME_FACE_NORMALS_AS_HARD_EDGES, "faceNormalsAsHardEdges",
+	                                      MFnNumericData::kBoolean, false, &stat);
+	MCHECK(stat);
+	MCHECK(nAttr.setCached(true));
+	MCHECK(nAttr.setStorable(true));
+	MCHECK(nAttr.setNiceNameOverride(MString("Face Normals as Hard Edges")));
+	MCHECK(addAttribute(faceNormalsAsHardEdges));
+	MCHECK(attributeAffects(faceNormalsAsHardEdges, outMesh));
+
+	emitReports = nAttr.create(NAME_EMIT_REPORTS, "emitReports", MFnNumericData::kBoolean, false, &stat);
+	MCHECK(stat);
+	MCHECK(nAttr.setCached(true));
+	MCHECK(nAttr.setStorable(true));
+	MCHECK(nAttr.setNiceNameOverride(MString("Emit Reports")));
+	MCHECK(addAttribute(emitReports));
+	MCHECK(attributeAffects(emitReports, outMesh));
+
+	updateTrigger = nAttr.create("updateTrigger", "updateTrigger", MFnNumericData::kInt, 0, &stat);
+	MCHECK(stat);
+	MCHECK(nAttr.setStorable(false));
+	MCHECK(nAttr.setHidden(true));
+	MCHECK(nAttr.setConnectable(false));
+	MCHECK(addAttribute(updateTrigger));
+	MCHECK(attributeAffects(updateTrigger, outMesh));
+
 	currentRulePkg = fAttr.create("current" + NAME_RULE_PKG, "currentRulePkg", MFnData::kString,
 	                              stringData.create(&stat2), &stat);
 	MCHECK(stat2);
@@ -25,16 +25,35 @@
 #include "PRTContext.h"
 
 #include "maya/MObject.h"
+#include "maya/MPlug.h"
 #include "maya/MStatus.h"
 #include "maya/MTypeId.h"
 
+#include <optional>
+#include <vector>
+
 class PRTModifierNode : public polyModifierNode {
 public:
 	MStatus compute(const MPlug& plug, MDataBlock& data) override;
 	MStatus setDependentsDirty(const MPlug& plugBeingDirtied, MPlugArray& affectedPlugs) override;
 
+	// compute still changes dynamic attributes and other plugs, reports to the script editor and flushes the global
+	// PRT cache, none of which is safe while other serlio nodes are computed
+	SchedulingType schedulingType() const override {
+		return SchedulingType::kGloballySerial;
+	}
+
 	static MStatus initialize();
 
+	// generates all given nodes with a single prt::generate call before their first compute
+	static MStatus prefetch(const std::vector<MObject>& nodes);
+
+	// DG connection callback, updates the serlio nodes whose material consumers might have changed
+	static void connectionChanged(MPlug& srcPlug, MPlug& destPlug, bool made, void* clientData);
+
+	// dirties outMesh of node through updateTrigger, only call on the main thread and outside of compute
+	static void triggerUpdate(const MObject& node);
+
 public:
 	// non-dynamic node attributes
 	static MObject rulePkg;
@@ -42,6 +61,31 @@ public:
 	static MObject currentRulePkg;
 	static MTypeId id;
 	static MObject mRandomSeed;
+	static MObject asyncGenerate;
+
+	// Preview sets the "LOD" rule attribute to 0, Bounding Boxes additionally reduces the output to one box per
+	// instance
+	static MObject levelOfDetail;
+
+	// meshes with face normals only get hard edges instead of locked normals
+	static MObject faceNormalsAsHardEdges;
+
+	// stores the CGA reports in the metadata of the generated mesh, see serlioReports
+	static MObject emitReports;
+
+	// hidden input which is changed to recompute outMesh without any other input change, see triggerUpdate()
+	static MObject updateTrigger;
 
 	PRTModifierAction fPRTModifierAction;
+
+private:
+	bool mInMeshChanged = true;
+
+	// whether a serlio material node is downstream of outMesh, only updated outside of compute on connection changes
+	// (materials are emitted as long as it is unknown)
+	std::optional<bool> mHasMaterialConsumer;
+	bool hasMaterialConsumer() const {
+		return mHasMaterialConsumer.value_or(true);
+	}
+	void updateMaterialConsumer();
 };
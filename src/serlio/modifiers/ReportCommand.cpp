@@ -0,0 +1,199 @@
+/**
+ * Serlio - Esri CityEngine Plugin for Autodesk Maya
+ *
+ * See https://github.com/esri/serlio for build and usage instructions.
+ *
+ * Copyright (c) 2012-2022 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "modifiers/ReportCommand.h"
+#include "modifiers/ReportInfo.h"
+
+#include "utils/MayaUtilities.h"
+
+#include "maya/MArgList.h"
+#include "maya/MDagPath.h"
+#include "maya/MDoubleArray.h"
+#include "maya/MFnMesh.h"
+#include "maya/MGlobal.h"
+#include "maya/MIntArray.h"
+#include "maya/MItSelectionList.h"
+#include "maya/MSelectionList.h"
+#include "maya/MStringArray.h"
+#include "maya/adskDataAssociations.h"
+#include "maya/adskDataStream.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const MString FLAG_FACE_RANGES = "-faceRanges";
+const MString FLAG_FACE_RANGES_SHORT = "-fr";
+
+MString getReportText(adsk::Data::Handle& handle) {
+	handle.setPositionByMemberName(PRT_REPORT_VALUE.c_str());
+	const char* str = reinterpret_cast<const char*>(handle.asUInt8());
+	return MString(str, static_cast<int>(strnlen(str, REPORT_MAX_STRING_LENGTH)));
+}
+
+std::vector<MString> getReportTexts(adsk::Data::Stream& stream) {
+	std::vector<MString> texts(stream.elementCount());
+	for (adsk::Data::Stream::iterator it = stream.begin(); it != stream.end(); ++it) {
+		if (it.index() < texts.size())
+			texts[it.index()] = getReportText(*it);
+	}
+	return texts;
+}
+
+std::vector<std::pair<int32_t, int32_t>> getReportFaceRanges(adsk::Data::Stream& stream) {
+	std::vector<std::pair<int32_t, int32_t>> faceRanges(stream.elementCount(), {0, 0});
+	for (adsk::Data::Stream::iterator it = stream.begin(); it != stream.end(); ++it) {
+		if (it.index() >= faceRanges.size())
+			continue;
+		adsk::Data::Handle& handle = *it;
+		handle.setPositionByMemberName(PRT_REPORT_FACE_INDEX_START.c_str());
+		faceRanges[it.index()].first = handle.asInt32()[0];
+		handle.setPositionByMemberName(PRT_REPORT_FACE_INDEX_END.c_str());
+		faceRanges[it.index()].second = handle.asInt32()[0];
+	}
+	return faceRanges;
+}
+
+} // namespace
+
+bool ReportCommand::isUndoable() const {
+	return false;
+}
+
+MStatus ReportCommand::doIt(const MArgList& argList) {
+	MStatus status;
+
+	bool returnFaceRanges = false;
+	MString key;
+	for (unsigned int i = 0; i < argList.length(); i++) {
+		const MString arg = argList.asString(i, &status);
+		MCHECK(status);
+		if ((arg == FLAG_FACE_RANGES) || (arg == FLAG_FACE_RANGES_SHORT)) {
+			returnFaceRanges = true;
+		}
+		else if (key.length() == 0) {
+			key = arg;
+		}
+		else {
+			displayError("At most one report key expected");
+			return MS::kFailure;
+		}
+	}
+	if (returnFaceRanges && (key.length() == 0)) {
+		displayError("A report key is required to query its face ranges");
+		return MS::kFailure;
+	}
+
+	MSelectionList selList;
+	MGlobal::getActiveSelectionList(selList);
+	MItSelectionList selListIter(selList);
+	selListIter.setFilter(MFn::kMesh);
+
+	MDagPath dagPath;
+	if (selListIter.isDone() || (selListIter.getDagPath(dagPath) != MS::kSuccess)) {
+		displayError("No mesh selected");
+		return MS::kFailure;
+	}
+
+	const MFnMesh fnMesh(dagPath, &status);
+	MCHECK(status);
+	const adsk::Data::Associations* metadata = fnMesh.metadata(&status);
+	MCHECK(status);
+	if (metadata == nullptr)
+		return MS::kSuccess;
+
+	adsk::Data::Associations associations(metadata);
+	adsk::Data::Channel* reportChannel = associations.findChannel(PRT_REPORT_CHANNEL);
+	if (reportChannel == nullptr)
+		return MS::kSuccess;
+
+	if (key.length() == 0) {
+		adsk::Data::Stream* keyStream = reportChannel->findDataStream(PRT_REPORT_KEY_STREAM);
+		if (keyStream == nullptr)
+			return MS::kSuccess;
+
+		MStringArray keys;
+		for (const MString& key : getReportTexts(*keyStream))
+			keys.append(key);
+		setResult(keys);
+		return MS::kSuccess;
+	}
+
+	const std::string streamName = PRT_REPORT_COLUMN_STREAM_PREFIX + key.asChar();
+	adsk::Data::Stream* column = reportChannel->findDataStream(streamName);
+	if (column == nullptr) {
+		displayError("Unknown report key '" + key + "'");
+		return MS::kFailure;
+	}
+
+	if (returnFaceRanges) {
+		adsk::Data::Stream* faceRangeStream = reportChannel->findDataStream(PRT_REPORT_FACE_RANGE_STREAM);
+		const std::vector<std::pair<int32_t, int32_t>> faceRanges =
+		        (faceRangeStream != nullptr) ? getReportFaceRanges(*faceRangeStream)
+		                                     : std::vector<std::pair<int32_t, int32_t>>();
+
+		// the column is sparse, its element indices are the indices of the reporting face ranges
+		MIntArray values;
+		for (adsk::Data::Stream::iterator it = column->begin(); it != column->end(); ++it) {
+			const std::pair<int32_t, int32_t> faceRange =
+			        (it.index() < faceRanges.size()) ? faceRanges[it.index()] : std::make_pair(-1, -1);
+			values.append(faceRange.first);
+			values.append(faceRange.second);
+		}
+		setResult(values);
+		return MS::kSuccess;
+	}
+
+	const std::string structureName = column->structure().name();
+	if (structureName == PRT_REPORT_FLOAT_STRUCTURE) {
+		MDoubleArray values;
+		for (adsk::Data::Handle& handle : *column) {
+			handle.setPositionByMemberName(PRT_REPORT_VALUE.c_str());
+			values.append(handle.asDouble()[0]);
+		}
+		setResult(values);
+	}
+	else if (structureName == PRT_REPORT_BOOL_STRUCTURE) {
+		MIntArray values;
+		for (adsk::Data::Handle& handle : *column) {
+			handle.setPositionByMemberName(PRT_REPORT_VALUE.c_str());
+			values.append(handle.asBoolean()[0] ? 1 : 0);
+		}
+		setResult(values);
+	}
+	else if (structureName == PRT_REPORT_STRING_STRUCTURE) {
+		adsk::Data::Stream* stringStream = reportChannel->findDataStream(PRT_REPORT_STRING_STREAM);
+		const std::vector<MString> strings =
+		        (stringStream != nullptr) ? getReportTexts(*stringStream) : std::vector<MString>();
+
+		MStringArray values;
+		for (adsk::Data::Handle& handle : *column) {
+			handle.setPositionByMemberName(PRT_REPORT_VALUE.c_str());
+			// keep one value per face range, see -faceRanges
+			const int32_t stringIndex = handle.asInt32()[0];
+			const bool isValidIndex = (stringIndex >= 0 && static_cast<size_t>(stringIndex) < strings.size());
+			values.append(isValidIndex ? strings[stringIndex] : MString());
+		}
+		setResult(values);
+	}
+
+	return MS::kSuccess;
+}
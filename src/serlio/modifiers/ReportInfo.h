@@ -0,0 +1,45 @@
+/**
+ * Serlio - Esri CityEngine Plugin for Autodesk Maya
+ *
+ * See https://github.com/esri/serlio for build and usage instructions.
+ *
+ * Copyright (c) 2012-2022 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+// CGA reports are stored column-wise in the metadata of the generated mesh:
+// - one sparse stream per report key with one element per face range which reports the key
+// - the face ranges (one element per range) and the report keys in separate streams
+// - string values as indices into a string table, each distinct string is only stored once
+const std::string PRT_REPORT_CHANNEL = "prtReportChannel";
+const std::string PRT_REPORT_FACE_RANGE_STREAM = "prtReportFaceRanges";
+const std::string PRT_REPORT_KEY_STREAM = "prtReportKeys";
+const std::string PRT_REPORT_STRING_STREAM = "prtReportStrings";
+const std::string PRT_REPORT_COLUMN_STREAM_PREFIX = "report:";
+
+const std::string PRT_REPORT_FACE_RANGE_STRUCTURE = "prtReportFaceRangeStructure";
+const std::string PRT_REPORT_TEXT_STRUCTURE = "prtReportTextStructure"; // elements of the key and string streams
+const std::string PRT_REPORT_BOOL_STRUCTURE = "prtReportBoolStructure";
+const std::string PRT_REPORT_FLOAT_STRUCTURE = "prtReportFloatStructure";
+const std::string PRT_REPORT_STRING_STRUCTURE = "prtReportStringStructure"; // index into the string stream
+
+const std::string PRT_REPORT_FACE_INDEX_START = "faceIndexStart";
+const std::string PRT_REPORT_FACE_INDEX_END = "faceIndexEnd";
+const std::string PRT_REPORT_VALUE = "value";
+
+// workaround: like the material strings, report texts are transported as uint8 arrays because kString crashes maya
+constexpr unsigned int REPORT_MAX_STRING_LENGTH = 400;
@@ -20,8 +20,10 @@
 #include "PRTContext.h"
 #include "serlioPlugin.h"
 
+#include "modifiers/GenerateScheduler.h"
 #include "modifiers/PRTModifierCommand.h"
 #include "modifiers/PRTModifierNode.h"
+#include "modifiers/ReportCommand.h"
 
 #include "materials/ArnoldMaterialNode.h"
 #include "materials/MaterialCommand.h"
@@ -29,8 +31,11 @@
 
 #include "utils/MayaUtilities.h"
 
+#include "maya/MCallbackIdArray.h"
+#include "maya/MDGMessage.h"
 #include "maya/MFnPlugin.h"
 #include "maya/MGlobal.h"
+#include "maya/MMessage.h"
 #include "maya/MSceneMessage.h"
 #include "maya/MStatus.h"
 #include "maya/MString.h"
@@ -45,12 +50,16 @@ constexpr const char* NODE_MATERIAL = "serlioMaterial";
 constexpr const char* NODE_ARNOLD_MATERIAL = "serlioArnoldMaterial";
 constexpr const char* CMD_CREATE_MATERIAL = "serlioCreateMaterial";
 constexpr const char* CMD_ASSIGN = "serlioAssign";
+constexpr const char* CMD_REPORTS = "serlioReports";
 constexpr const char* MEL_PROC_CREATE_UI = "serlioCreateUI";
 constexpr const char* MEL_PROC_DELETE_UI = "serlioDeleteUI";
 constexpr const char* SERLIO_VENDOR = "Esri R&D Center Zurich";
 
 std::once_flag callbackRegisterFlag;
 
+// callbacks which are registered while the plugin is loaded
+MCallbackIdArray pluginCallbackIds;
+
 } // namespace
 
 // called when the plug-in is loaded into Maya.
@@ -68,6 +77,21 @@ MStatus initializePlugin(MObject obj) {
 		MCHECK(mayaStatus);
 	});
 
+	MStatus callbackStatus = MStatus::kFailure;
+	auto workspaceChangedCallback = [](void*) { mu::updateCachedWorkspaceRoot(); };
+	const MCallbackId workspaceChangedCallbackId = MSceneMessage::addCallback(
+	        MSceneMessage::kWorkspaceChanged, workspaceChangedCallback, nullptr, &callbackStatus);
+	MCHECK(callbackStatus);
+	if (callbackStatus == MStatus::kSuccess)
+		pluginCallbackIds.append(workspaceChangedCallbackId);
+
+	const MCallbackId connectionCallbackId =
+	        MDGMessage::addConnectionCallback(PRTModifierNode::connectionChanged, nullptr, &callbackStatus);
+	MCHECK(callbackStatus);
+	if (callbackStatus == MStatus::kSuccess)
+		pluginCallbackIds.append(connectionCallbackId);
+	mu::updateCachedWorkspaceRoot();
+
 	MFnPlugin plugin(obj, SERLIO_VENDOR, SRL_VERSION);
 
 	auto createModifierCommand = []() { return (void*)new PRTModifierCommand(); };
@@ -76,6 +100,9 @@ MStatus initializePlugin(MObject obj) {
 	auto createMaterialCommand = []() { return (void*)new MaterialCommand(); };
 	MCHECK(plugin.registerCommand(CMD_CREATE_MATERIAL, createMaterialCommand));
 
+	auto createReportCommand = []() { return (void*)new ReportCommand(); };
+	MCHECK(plugin.registerCommand(CMD_REPORTS, createReportCommand));
+
 	auto createModifierNode = []() { return (void*)new PRTModifierNode(); };
 	MCHECK(plugin.registerNode(NODE_MODIFIER, PRTModifierNode::id, createModifierNode, PRTModifierNode::initialize));
 
@@ -101,9 +128,18 @@ MStatus uninitializePlugin(MObject obj) {
 	// * PRT only supports initializing once per process life time
 
 	MStatus status;
+	// the background thread generates into nodes which are about to go away
+	GenerateScheduler::get().shutdown();
+
+	if (pluginCallbackIds.length() > 0) {
+		MCHECK(MMessage::removeCallbacks(pluginCallbackIds));
+		pluginCallbackIds.clear();
+	}
+
 	if (obj != MObject::kNullObj) { // TODO
 		MFnPlugin plugin(obj);
 		MCHECK(plugin.deregisterCommand(CMD_ASSIGN));
+		MCHECK(plugin.deregisterCommand(CMD_REPORTS));
 		MCHECK(plugin.deregisterNode(PRTModifierNode::id));
 		MCHECK(plugin.deregisterNode(StingrayMaterialNode::id));
 		MCHECK(plugin.deregisterNode(ArnoldMaterialNode::id));
@@ -53,6 +53,7 @@ std::filesystem::path AssetCache::put(const wchar_t* uri, const wchar_t* fileNam
 	const size_t hash = std::hash<std::string_view>{}(bufferView);
 	const auto key = std::make_pair(stringUri, hash);
 
+	std::lock_guard<std::mutex> lock(mMutex);
 	const auto it = mCache.find(key);
 
 	// reuse cached asset if uri and hash match
@@ -74,6 +75,7 @@ std::filesystem::path AssetCache::put(const wchar_t* uri, const wchar_t* fileNam
 		LOG_ERR << "Failed to put asset into cache, skipping asset: " << newAssetPath;
 		return {};
 	}
+	mTextureMetadataCache.setWritten(newAssetPath, size);
 
 	if (it == mCache.end()) {
 		mCache.emplace(key, newAssetPath);
@@ -19,20 +19,31 @@
 
 #pragma once
 
+#include "utils/TextureMetadataCache.h"
 #include "utils/Utilities.h"
 
 #include <filesystem>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
+// thread-safe, assets are written by the encoder callbacks of concurrently running generate calls
 class AssetCache {
 public:
 	std::filesystem::path put(const wchar_t* uri, const wchar_t* fileName, const std::filesystem::path workspaceRoot,
 	                          const uint8_t* buffer, size_t size);
 
+	// the texture metadata cache is owned by the asset cache to forget about assets as soon as they are (re)written
+	TextureMetadataCache& getTextureMetadataCache() {
+		return mTextureMetadataCache;
+	}
+
 private:
 	std::filesystem::path getCachedPath(const wchar_t* fileName, const std::filesystem::path workspaceRoot,
 	                                    const size_t hash) const;
 
+	// guards the cache and the asset files, so concurrent puts of the same asset do not write the same file
+	std::mutex mMutex;
 	std::unordered_map<std::pair<std::wstring, size_t>, std::filesystem::path, prtu::pair_hash> mCache;
+	TextureMetadataCache mTextureMetadataCache;
 };
@@ -140,15 +140,23 @@ void MELScriptBuilder::setVar(const MELVariable& varName, const MELStringLiteral
 	commandStream << varName.mel() << " = " << val.mel() << ";\n";
 }
 
+void MELScriptBuilder::setVar(const MELVariable& varName, const MELVariable& val) {
+	commandStream << varName.mel() << " = " << val.mel() << ";\n";
+}
+
 void MELScriptBuilder::setsCreate(const MELVariable& setName) {
 	const auto mel = setName.mel();
 	commandStream << mel << "= `sets -empty -renderable true -noSurfaceShader true -name " << mel << "`;\n";
 }
 
-void MELScriptBuilder::setsAddFaceRange(const std::wstring& setName, const std::wstring& meshName, const int faceStart,
-                                        const int faceEnd) {
-	commandStream << "sets -forceElement " << setName << " " << meshName << ".f[" << faceStart << ":" << faceEnd
-	              << "];\n";
+void MELScriptBuilder::setsAddFaceRanges(const std::wstring& setName, const std::wstring& meshName,
+                                         const std::vector<std::pair<int, int>>& faceRanges) {
+	if (faceRanges.empty())
+		return;
+	commandStream << "sets -forceElement " << setName;
+	for (const auto& faceRange : faceRanges)
+		commandStream << " " << meshName << ".f[" << faceRange.first << ":" << (faceRange.second - 1) << "]";
+	commandStream << ";\n";
 }
 
 void MELScriptBuilder::setsUseInitialShadingGroup(const std::wstring& meshName) {
@@ -170,6 +178,34 @@ void MELScriptBuilder::forceValidTextureAlphaChannel(const MELVariable& nodeName
 	              << composeAttributeExpression(nodeName, L"fileHasAlpha") << "`);";
 }
 
+void MELScriptBuilder::duplicateUpstream(const MELVariable& nodeName, const MELVariable& copyName) {
+	commandStream << "{ string $serlioDuplicates[] = `duplicate -upstreamNodes " << nodeName.mel() << "`; "
+	              << copyName.mel() << " = $serlioDuplicates[0];\n";
+
+	// shadingNode registers the nodes it creates, duplicate does not
+	commandStream << "string $serlioDuplicate; for ($serlioDuplicate in $serlioDuplicates) { "
+	                 "string $serlioType = `nodeType $serlioDuplicate`; "
+	                 "if (`getClassification -satisfies \"texture\" $serlioType`) "
+	                 "connectAttr -nextAvailable ($serlioDuplicate + \".message\") defaultTextureList1.textures; "
+	                 "else if (`getClassification -satisfies \"shader\" $serlioType` || "
+	                 "`getClassification -satisfies \"utility\" $serlioType`) "
+	                 "connectAttr -nextAvailable ($serlioDuplicate + \".message\") defaultShaderList1.shaders; }\n";
+	commandStream << "}\n";
+}
+
+void MELScriptBuilder::getSourceNode(const MELVariable& nodeName, const std::wstring& attribute,
+                                     const MELVariable& sourceNodeName) {
+	commandStream << "{ string $serlioSources[] = `listConnections -source true -destination false "
+	                 "-skipConversionNodes true "
+	              << composeAttributeExpression(nodeName, attribute) << "`; " << sourceNodeName.mel()
+	              << " = $serlioSources[0]; }\n";
+}
+
+void MELScriptBuilder::rename(const MELVariable& nodeName, const MELStringLiteral& newName) {
+	const auto mel = nodeName.mel();
+	commandStream << mel << " = `rename " << mel << " " << newName.mel() << "`;\n";
+}
+
 void MELScriptBuilder::getUndoState(const MELVariable& undoName) {
 	const auto mel = undoName.mel();
 	commandStream << mel << " = `undoInfo -q -state`;\n";
@@ -193,6 +229,11 @@ void MELScriptBuilder::getWorkspaceDir() {
 	commandStream << L"workspace -q -rd;\n";
 }
 
+void MELScriptBuilder::dgDirty(const MELStringLiteral& nodeUuid, const std::wstring& attribute) {
+	commandStream << "{ string $serlioDirtyNodes[] = `ls " << nodeUuid.mel() << "`; if (size($serlioDirtyNodes) > 0) "
+	              << "dgdirty ($serlioDirtyNodes[0] + " << std::quoted(L'.' + attribute) << "); }\n";
+}
+
 MStatus MELScriptBuilder::executeSync(std::wstring& output) {
 	MStatus status;
 	MString result =
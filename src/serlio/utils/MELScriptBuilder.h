@@ -27,6 +27,8 @@
 #include <cassert>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 class MaterialColor;
 
@@ -74,21 +76,35 @@ public:
 	void declString(const MELVariable& varName);
 
 	void setVar(const MELVariable& varName, const MELStringLiteral& val);
+	void setVar(const MELVariable& varName, const MELVariable& val);
 
 	void setsCreate(const MELVariable& setName);
-	void setsAddFaceRange(const std::wstring& setName, const std::wstring& meshName, int faceStart, int faceEnd);
+	// face ranges are half-open [start, end), all ranges are assigned with a single sets command
+	void setsAddFaceRanges(const std::wstring& setName, const std::wstring& meshName,
+	                       const std::vector<std::pair<int, int>>& faceRanges);
 	void setsUseInitialShadingGroup(const std::wstring& meshName);
 
 	void createShader(const std::wstring& shaderType, const MELVariable& nodeName);
 	void createTextureShadingNode(const MELVariable& nodeName);
 	void forceValidTextureAlphaChannel(const MELVariable& nodeName);
 
+	// duplicates the node including all its upstream nodes and stores the name of the node copy in copyName
+	// like createShader() and createTextureShadingNode(), the copies are added to the default shader/texture lists
+	void duplicateUpstream(const MELVariable& nodeName, const MELVariable& copyName);
+	// stores the name of the node connected to the destination attribute in sourceNodeName
+	void getSourceNode(const MELVariable& nodeName, const std::wstring& attribute, const MELVariable& sourceNodeName);
+	// renames the node and stores the new (possibly uniquified) name back into the variable
+	void rename(const MELVariable& nodeName, const MELStringLiteral& newName);
+
 	void getUndoState(const MELVariable& undoName);
 	void setUndoState(const MELVariable& undoName);
 	void setUndoState(bool undoState);
 
 	void getWorkspaceDir();
 
+	// marks the attribute of the node with the given uuid dirty, does nothing if the node no longer exists
+	void dgDirty(const MELStringLiteral& nodeUuid, const std::wstring& attribute);
+
 	void addCmdLine(const std::wstring& line);
 
 	MStatus executeSync(std::wstring& output);
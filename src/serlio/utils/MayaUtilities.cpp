@@ -29,9 +29,13 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 
 namespace {
+std::mutex workspaceRootMutex;
+std::filesystem::path cachedWorkspaceRoot;
+
 constexpr const wchar_t KEY_URL_SEPARATOR = L'=';
 const MString INDIRECTION_URL = L"https://raw.githubusercontent.com/Esri/serlio/data/urls.json";
 const MString SERLIO_HOME_KEY = "SERLIO_HOME";
@@ -143,6 +147,20 @@ std::filesystem::path getWorkspaceRoot(MStatus& status) {
 	}
 }
 
+std::filesystem::path getCachedWorkspaceRoot() {
+	std::lock_guard<std::mutex> lock(workspaceRootMutex);
+	return cachedWorkspaceRoot;
+}
+
+void updateCachedWorkspaceRoot() {
+	MStatus status;
+	std::filesystem::path workspaceRoot = getWorkspaceRoot(status);
+	MCHECK(status);
+
+	std::lock_guard<std::mutex> lock(workspaceRootMutex);
+	cachedWorkspaceRoot = std::move(workspaceRoot);
+}
+
 MStatus registerMStringResources() {
 	std::map<std::string, std::string> keyToUrlMap = getKeyToUrlMap();
 
@@ -69,8 +69,13 @@ private:
 	T value_;
 };
 
+// runs MEL, only call from the main thread
 std::filesystem::path getWorkspaceRoot(MStatus& status);
 
+// workspace root as of the last updateCachedWorkspaceRoot() call on the main thread, safe to call from any thread
+std::filesystem::path getCachedWorkspaceRoot();
+void updateCachedWorkspaceRoot();
+
 MStatus registerMStringResources();
 
 MStatus setEnumOptions(const MObject& node, MFnEnumAttribute& enumAttr, const std::vector<std::wstring>& enumOptions,
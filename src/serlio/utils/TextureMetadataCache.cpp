@@ -0,0 +1,86 @@
+/**
+ * Serlio - Esri CityEngine Plugin for Autodesk Maya
+ *
+ * See https://github.com/esri/serlio for build and usage instructions.
+ *
+ * Copyright (c) 2012-2022 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/TextureMetadataCache.h"
+
+#include "utils/LogHandler.h"
+#include "utils/Utilities.h"
+
+#include <cwchar>
+#include <system_error>
+
+namespace {
+
+constexpr bool DBG = false;
+
+constexpr const wchar_t* RGBA8_FORMAT = L"RGBA8";
+constexpr const wchar_t* FORMAT_STRING = L"format";
+
+bool readHasAlphaChannel(const std::filesystem::path& texturePath) {
+	const AttributeMapUPtr textureMetadata(prt::createTextureMetadata(prtu::toFileURI(texturePath.wstring()).c_str()));
+	if (textureMetadata == nullptr)
+		return false;
+	const wchar_t* format = textureMetadata->getString(FORMAT_STRING);
+	return (format != nullptr && std::wcscmp(format, RGBA8_FORMAT) == 0);
+}
+
+} // namespace
+
+bool TextureMetadataCache::hasAlphaChannel(const std::filesystem::path& texturePath) {
+	std::error_code errorCode;
+	const std::filesystem::file_time_type timeStamp = std::filesystem::last_write_time(texturePath, errorCode);
+	const uintmax_t fileSize = errorCode ? 0 : std::filesystem::file_size(texturePath, errorCode);
+	if (errorCode)
+		return readHasAlphaChannel(texturePath); // let PRT decide, e.g. for non-file URIs, but do not cache
+
+	const std::wstring key = texturePath.wstring();
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		const auto it = mCache.find(key);
+		if (it != mCache.end() && it->second.mTimeStamp == timeStamp && it->second.mFileSize == fileSize &&
+		    it->second.mHasAlphaChannel.has_value())
+			return *it->second.mHasAlphaChannel;
+	}
+
+	// read the texture header without holding the lock, concurrent readers of the same texture are harmless
+	const bool hasAlphaChannel = readHasAlphaChannel(texturePath);
+	if (DBG)
+		LOG_DBG << "read texture metadata of " << key << ": hasAlphaChannel = " << hasAlphaChannel;
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mCache[key] = {timeStamp, fileSize, hasAlphaChannel};
+	return hasAlphaChannel;
+}
+
+void TextureMetadataCache::setWritten(const std::filesystem::path& texturePath, uintmax_t fileSize) {
+	std::error_code errorCode;
+	const std::filesystem::file_time_type timeStamp = std::filesystem::last_write_time(texturePath, errorCode);
+
+	if (errorCode) {
+		std::lock_guard<std::mutex> lock(mMutex);
+		mCache.erase(texturePath.wstring());
+		return;
+	}
+
+	// read the header once while the written file is likely still in the file system cache
+	const bool hasAlphaChannel = readHasAlphaChannel(texturePath);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+	mCache[texturePath.wstring()] = {timeStamp, fileSize, hasAlphaChannel};
+}
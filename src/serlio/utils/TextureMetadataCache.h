@@ -0,0 +1,52 @@
+/**
+ * Serlio - Esri CityEngine Plugin for Autodesk Maya
+ *
+ * See https://github.com/esri/serlio for build and usage instructions.
+ *
+ * Copyright (c) 2012-2022 Esri R&D Center Zurich
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+// Caches texture properties derived from the texture file header. Entries are validated against the modification
+// time and size of the file, so textures changed on disk are re-read.
+class TextureMetadataCache {
+public:
+	TextureMetadataCache() = default;
+	TextureMetadataCache(const TextureMetadataCache&) = delete;
+	TextureMetadataCache(TextureMetadataCache&&) = delete;
+	TextureMetadataCache& operator=(TextureMetadataCache const&) = delete;
+	TextureMetadataCache& operator=(TextureMetadataCache&&) = delete;
+
+	bool hasAlphaChannel(const std::filesystem::path& texturePath);
+	// records the state and metadata of a texture file which was just written, so later queries do not read it again
+	void setWritten(const std::filesystem::path& texturePath, uintmax_t fileSize);
+
+private:
+	struct TextureMetadata {
+		std::filesystem::file_time_type mTimeStamp;
+		uintmax_t mFileSize;
+		std::optional<bool> mHasAlphaChannel; // empty until read from the texture
+	};
+
+	std::mutex mMutex;
+	std::unordered_map<std::wstring, TextureMetadata> mCache;
+};
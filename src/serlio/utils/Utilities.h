@@ -39,6 +39,8 @@
 #include <memory>
 #include <ostream>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 // PRT version >= VERSION_MAJOR.VERSION_MINOR
@@ -66,6 +68,7 @@ using InitialShapeNOPtrVector = std::vector<const prt::InitialShape*>;
 using AttributeMapNOPtrVector = std::vector<const prt::AttributeMap*>;
 using CacheObjectUPtr = std::unique_ptr<prt::CacheObject, PRTDestroyer>;
 using AttributeMapUPtr = std::unique_ptr<const prt::AttributeMap, PRTDestroyer>;
+using AttributeMapSPtr = std::shared_ptr<const prt::AttributeMap>;
 using AttributeMapVector = std::vector<AttributeMapUPtr>;
 using AttributeMapBuilderUPtr = std::unique_ptr<prt::AttributeMapBuilder, PRTDestroyer>;
 using AttributeMapBuilderSPtr = std::shared_ptr<prt::AttributeMapBuilder>;
@@ -113,6 +116,39 @@ struct pair_hash {
 	}
 };
 
+// 64-bit FNV-1a hash, accumulated over raw bytes in a single pass: http://www.isthe.com/chongo/tech/comp/fnv/
+class Fnv1aHash {
+public:
+	void add(const void* data, size_t size) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; i++) {
+			mValue ^= bytes[i];
+			mValue *= 1099511628211ull;
+		}
+	}
+
+	template <typename T>
+	void add(const T& value) {
+		static_assert(std::is_trivially_copyable<T>::value, "only raw bytes can be hashed");
+		add(&value, sizeof(T));
+	}
+
+	uint64_t value() const {
+		return mValue;
+	}
+
+private:
+	uint64_t mValue = 14695981039346656037ull;
+};
+
+// appends the half-open face range [first, second), merged into the last range if they are adjacent
+inline void appendFaceRange(std::vector<std::pair<int, int>>& faceRanges, const std::pair<int, int>& faceRange) {
+	if (!faceRanges.empty() && (faceRanges.back().second == faceRange.first))
+		faceRanges.back().second = faceRange.second;
+	else
+		faceRanges.push_back(faceRange);
+}
+
 time_t getFileModificationTime(const std::wstring& p);
 
 int fromHex(wchar_t c);
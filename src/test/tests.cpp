@@ -22,12 +22,17 @@
 #include "modifiers/RuleAttributes.h"
 
 #include "utils/LogHandler.h"
+#include "utils/TextureMetadataCache.h"
 #include "utils/Utilities.h"
 
+#include "encoder/MaterialAttributeBlacklist.h"
+
 #define CATCH_CONFIG_RUNNER
 #define CATCH_CONFIG_FAST_COMPILE
 #include "catch2/catch.hpp"
 
+#include <filesystem>
+#include <fstream>
 #include <sstream>
 
 namespace {
@@ -469,6 +474,129 @@ TEST_CASE("cleanNameForMaya") {
 	}
 }
 
+TEST_CASE("appendFaceRange") {
+	std::vector<std::pair<int, int>> faceRanges;
+
+	SECTION("adjacent") {
+		prtu::appendFaceRange(faceRanges, {0, 2});
+		prtu::appendFaceRange(faceRanges, {2, 5});
+		prtu::appendFaceRange(faceRanges, {5, 6});
+		const std::vector<std::pair<int, int>> expected = {{0, 6}};
+		CHECK(faceRanges == expected);
+	}
+	SECTION("gap") {
+		prtu::appendFaceRange(faceRanges, {0, 2});
+		prtu::appendFaceRange(faceRanges, {3, 5});
+		const std::vector<std::pair<int, int>> expected = {{0, 2}, {3, 5}};
+		CHECK(faceRanges == expected);
+	}
+	SECTION("only merged with last range") {
+		prtu::appendFaceRange(faceRanges, {4, 6});
+		prtu::appendFaceRange(faceRanges, {0, 4});
+		const std::vector<std::pair<int, int>> expected = {{4, 6}, {0, 4}};
+		CHECK(faceRanges == expected);
+	}
+}
+
+TEST_CASE("isBlacklisted") {
+	SECTION("blacklisted") {
+		CHECK(isBlacklisted(L"ambient.b"));
+		CHECK(isBlacklisted(L"colormap"));
+		CHECK(isBlacklisted(L"specularmap.tv"));
+#if PRT_VERSION_MAJOR > 1
+		CHECK(isBlacklisted(L"roughnessmap.tv"));
+#endif
+	}
+	SECTION("passed on") {
+		CHECK_FALSE(isBlacklisted(L""));
+		CHECK_FALSE(isBlacklisted(L"ambient"));
+		CHECK_FALSE(isBlacklisted(L"colormap.rwx"));
+		CHECK_FALSE(isBlacklisted(L"diffuseColor"));
+	}
+}
+
+TEST_CASE("Fnv1aHash") {
+	SECTION("reference values") {
+		CHECK(prtu::Fnv1aHash().value() == 0xcbf29ce484222325ull);
+
+		prtu::Fnv1aHash hashA;
+		hashA.add("a", 1);
+		CHECK(hashA.value() == 0xaf63dc4c8601ec8cull);
+
+		prtu::Fnv1aHash hashFoobar;
+		hashFoobar.add("foobar", 6);
+		CHECK(hashFoobar.value() == 0x85944171f73967e8ull);
+	}
+	SECTION("accumulated") {
+		prtu::Fnv1aHash hashInOne;
+		hashInOne.add("foobar", 6);
+
+		prtu::Fnv1aHash hashInParts;
+		hashInParts.add("foo", 3);
+		hashInParts.add("bar", 3);
+		CHECK(hashInParts.value() == hashInOne.value());
+	}
+	SECTION("typed value") {
+		const uint32_t value = 42;
+
+		prtu::Fnv1aHash hashTyped;
+		hashTyped.add(value);
+
+		prtu::Fnv1aHash hashRaw;
+		hashRaw.add(&value, sizeof(value));
+		CHECK(hashTyped.value() == hashRaw.value());
+	}
+}
+
+TEST_CASE("TextureMetadataCache") {
+	const std::filesystem::path texturePath = std::filesystem::temp_directory_path() / "serlio_test_texture.tga";
+
+	// writes an uncompressed 1x1 TGA image and returns its size
+	const auto writeTexture = [&texturePath](bool withAlpha) -> uintmax_t {
+		const uint8_t bitsPerPixel = withAlpha ? 32 : 24;
+		const uint8_t alphaBits = withAlpha ? 8 : 0;
+		std::vector<uint8_t> tga = {0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0, bitsPerPixel, alphaBits};
+		tga.resize(tga.size() + bitsPerPixel / 8, 0xff);
+
+		std::ofstream out(texturePath, std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<const char*>(tga.data()), tga.size());
+		return tga.size();
+	};
+
+	TextureMetadataCache cache;
+
+	SECTION("missing texture") {
+		CHECK_FALSE(cache.hasAlphaChannel(texturePath.parent_path() / "serlio_test_missing.tga"));
+	}
+	SECTION("changed texture") {
+		writeTexture(false);
+		CHECK_FALSE(cache.hasAlphaChannel(texturePath));
+		CHECK_FALSE(cache.hasAlphaChannel(texturePath));
+
+		// the size changes even if the modification time is within the file system resolution
+		writeTexture(true);
+		CHECK(cache.hasAlphaChannel(texturePath));
+	}
+	SECTION("written texture") {
+		writeTexture(false);
+		CHECK_FALSE(cache.hasAlphaChannel(texturePath));
+
+		const uintmax_t fileSize = writeTexture(true);
+		cache.setWritten(texturePath, fileSize);
+		const std::filesystem::file_time_type timeStamp = std::filesystem::last_write_time(texturePath);
+
+		// replace the content behind the back of the cache, a re-read would no longer find an alpha channel
+		{
+			std::ofstream out(texturePath, std::ios::binary | std::ios::trunc);
+			out << std::string(static_cast<size_t>(fileSize), '\0');
+		}
+		std::filesystem::last_write_time(texturePath, timeStamp);
+		CHECK(cache.hasAlphaChannel(texturePath));
+	}
+
+	std::filesystem::remove(texturePath);
+}
+
 // we use a custom main function to manage PRT lifetime
 int main(int argc, char* argv[]) {
 	const std::vector<std::wstring> addExtDirs = {